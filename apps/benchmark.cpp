@@ -3,10 +3,18 @@
 #include <unordered_map>
 #include <mutex>
 #include <functional>
+#include <cstring>
 
 #include "include/utils/graph_utils.hpp"
 #include "include/bmssp.hpp"
 #include "include/dijkstras.hpp"
+#include "include/batch_sssp.hpp"
+#include "include/delta_stepping.hpp"
+#include "include/bounded_sssp.hpp"
+#include "include/bidirectional_dijkstra.hpp"
+#include "include/dynamic_sssp.hpp"
+#include "include/many_to_many.hpp"
+#include "include/sssp_cache.hpp"
 
 using namespace std;
 
@@ -34,14 +42,107 @@ const vector<vector<int64_t>> grid_ARGS = {
     {10000, 1000}
 };
 
+// every graph argument is crossed with these thread counts for the batch benchmarks
+const vector<int64_t> THREAD_COUNTS = {1, 2, 4, 8, 16, 32};
+constexpr int BATCH_SOURCES_COUNT = 64;
+constexpr int ST_PAIRS_COUNT = 64;
+constexpr int UPDATES_PER_BATCH = 16;
+constexpr int MATRIX_SOURCES_COUNT = 64;
+constexpr int MATRIX_TARGETS_COUNT = 1024;
+constexpr int CACHED_QUERIES_COUNT = 64;
+constexpr int CACHED_HUBS_COUNT = 4; // most of the cached queries start at one of them
+constexpr int CACHED_RESULTS_BUDGET = 8; // in results of the graph
+
+vector<vector<int64_t>> with_threads(const vector<vector<int64_t>> &args) {
+    vector<vector<int64_t>> sortie;
+    for (const auto &arg : args) {
+        for (const int64_t &threads : THREAD_COUNTS) {
+            sortie.push_back(arg);
+            sortie.back().push_back(threads);
+        }
+    }
+    return sortie;
+}
+
+const vector<vector<int64_t>> batch_random_ARGS = with_threads({
+    {100000, 10},
+    {1000000, 10}
+});
+
+const vector<vector<int64_t>> parallel_random_ARGS = with_threads({
+    {1000000, 10},
+    {5000000, 10},
+    {10000000, 10}
+});
+
+const vector<vector<int64_t>> parallel_grid_ARGS = with_threads({
+    {1000, 1000},
+    {5000, 1000}
+});
+
+// every graph argument is crossed with these (k, t, l, hybrid_cutoff) for the BMSSP parameter sweep, 0 picks the
+// paper's value
+vector<vector<int64_t>> with_BMSSP_params(const vector<vector<int64_t>> &args) {
+    vector<vector<int64_t>> sortie;
+    for (const auto &arg : args) {
+        for (int64_t k : {1, 2, 3, 4}) {
+            for (int64_t t : {2, 3, 4, 6, 8}) {
+                for (int64_t l : {0, 6}) {
+                    sortie.push_back(arg);
+                    sortie.back().insert(sortie.back().end(), {k, t, l, 0});
+                }
+            }
+        }
+    }
+    return sortie;
+}
+
+// the paper's parameters with these hybrid cutoffs
+vector<vector<int64_t>> with_hybrid_cutoffs(const vector<vector<int64_t>> &args) {
+    vector<vector<int64_t>> sortie;
+    for (const auto &arg : args) {
+        for (int64_t cutoff : {0, 128, 1024, 8192, 65536, 1 << 20}) {
+            sortie.push_back(arg);
+            sortie.back().insert(sortie.back().end(), {0, 0, 0, cutoff});
+        }
+    }
+    return sortie;
+}
+
+const vector<vector<int64_t>> params_random_ARGS = with_BMSSP_params({
+    {100000, 10},
+    {1000000, 10}
+});
+
+const vector<vector<int64_t>> params_grid_ARGS = with_BMSSP_params({
+    {1000, 100}
+});
+
+const vector<vector<int64_t>> params_BGP_ARGS = with_BMSSP_params({{0}, {1}});
+
+const vector<vector<int64_t>> hybrid_random_ARGS = with_hybrid_cutoffs({
+    {100000, 10},
+    {1000000, 10}
+});
+
+const vector<vector<int64_t>> hybrid_grid_ARGS = with_hybrid_cutoffs({
+    {1000, 100},
+    {5000, 1000}
+});
+
+const vector<vector<int64_t>> hybrid_BGP_ARGS = with_hybrid_cutoffs({{0}, {1}});
+
 string data_path = string(PROJECT_ROOT) + "/data";
 const vector<string> FILES = {
     data_path + "/1199167200.1199170800.graphml",
     data_path + "/1702188000.1702191600.graphml"
 };
 
+const vector<vector<int64_t>> threaded_BGP_ARGS = with_threads({{0}, {1}});
+
 struct GraphDataset {
     Graph graph;
+    CSR_Graph csr_graph;
     int src;
     int64_t nodes_count;
     int64_t edges_count;
@@ -76,10 +177,13 @@ inline int get_a_source(Graph& graph) {
 class BenchFixture : public benchmark::Fixture {
 public:
     Graph *graph;
+    CSR_Graph *csr_graph;
     int src;
     int64_t nodes_count = 0;
     int64_t edges_count = 0;
     vector<Dist_T> *ref_dist;
+    int threads = 1;
+    BMSSP_Params bmssp_params;
 };
 
 class RandomGraphFixture : public BenchFixture {
@@ -93,6 +197,7 @@ public:
             GraphDataset d;
             string specs = "random nodes_count=" + to_string(N) + " max_weight=" + to_string(max_weight) + " seed=" + to_string(RANDOM_SEED);
             d.graph = go_get_that_graph(specs);
+            d.csr_graph = CSR_Graph(d.graph);
             d.nodes_count = N;
             d.edges_count = boost::num_edges(d.graph);
             d.src = get_a_source(d.graph);
@@ -101,6 +206,7 @@ public:
         });
 
         graph = &dataset.graph;
+        csr_graph = &dataset.csr_graph;
         src = dataset.src;
         nodes_count = dataset.nodes_count;
         edges_count = dataset.edges_count;
@@ -118,6 +224,7 @@ public:
             GraphDataset d;
             string specs = "random unweighted nodes_count=" + to_string(N) + " seed=" + to_string(RANDOM_SEED);
             d.graph = go_get_that_graph(specs);
+            d.csr_graph = CSR_Graph(d.graph);
             d.nodes_count = N;
             d.edges_count = boost::num_edges(d.graph);
             d.src = get_a_source(d.graph);
@@ -126,6 +233,7 @@ public:
         });
 
         graph = &dataset.graph;
+        csr_graph = &dataset.csr_graph;
         src = dataset.src;
         nodes_count = dataset.nodes_count;
         edges_count = dataset.edges_count;
@@ -144,6 +252,7 @@ public:
             GraphDataset d;
             string specs = "grid w=" + to_string(w) + " h=" + to_string(h);
             d.graph = go_get_that_graph(specs);
+            d.csr_graph = CSR_Graph(d.graph);
             d.nodes_count = boost::num_vertices(d.graph);
             d.edges_count = boost::num_edges(d.graph);
             d.src = get_a_source(d.graph);
@@ -152,6 +261,7 @@ public:
         });
 
         graph = &dataset.graph;
+        csr_graph = &dataset.csr_graph;
         src = dataset.src;
         nodes_count = dataset.nodes_count;
         edges_count = dataset.edges_count;
@@ -167,7 +277,15 @@ public:
         string key = "bgp_" + to_string(idx);
         auto& dataset = GraphRepository::get(key, [&]() {
             GraphDataset d;
-            d.graph = go_get_that_graph(FILES[idx]);
+            // the snapshot made by FileUtils::convert_bgp_graphml_to_csr_snapshot loads much faster
+            string snapshot = FileUtils::csr_snapshot_path(FILES[idx]);
+            if (FileUtils::file_exists(snapshot)) {
+                d.csr_graph = go_get_that_csr_graph(snapshot);
+                d.graph = d.csr_graph.to_graph();
+            } else {
+                d.graph = go_get_that_graph(FILES[idx]);
+                d.csr_graph = CSR_Graph(d.graph);
+            }
             d.nodes_count = boost::num_vertices(d.graph);
             d.edges_count = boost::num_edges(d.graph);
             d.src = get_a_source(d.graph);
@@ -176,6 +294,7 @@ public:
         });
 
         graph = &dataset.graph;
+        csr_graph = &dataset.csr_graph;
         src = dataset.src;
         nodes_count = dataset.nodes_count;
         edges_count = dataset.edges_count;
@@ -185,43 +304,207 @@ public:
 
 
 struct StdPQDijkstraAlgo {
-    auto operator()(Graph& g, int s, int64_t n) const {
-        return min_heap_dijkstra(g, s, n);
+    auto operator()(BenchFixture& f) const {
+        return min_heap_dijkstra(*f.csr_graph, f.src, f.nodes_count);
+    }
+};
+
+struct BucketDijkstraAlgo {
+    auto operator()(BenchFixture& f) const {
+        return bucket_dijkstra(*f.csr_graph, f.src, f.nodes_count);
+    }
+};
+
+struct DijkstraWorkspaceAlgo {
+    unique_ptr<Dijkstra_State> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<Dijkstra_State>(*f.csr_graph);
+        }
+        return dijkstra_query(*state, f.src, f.nodes_count);
+    }
+
+    size_t peak_heap_size() const { return state ? state->peak_heap_size : 0; }
+};
+
+template<int D>
+struct IndexedHeapDijkstraAlgo {
+    unique_ptr<Indexed_Dijkstra_State<D>> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<Indexed_Dijkstra_State<D>>(*f.csr_graph);
+        }
+        return indexed_dijkstra_query(*state, f.src, f.nodes_count);
     }
+
+    size_t peak_heap_size() const { return state ? state->peak_heap_size : 0; }
 };
 
 struct FiboDijkstraAlgo {
-    auto operator()(Graph& g, int s, int64_t n) const {
-        return fibo_heap_dijkstra(g, s, n);
+    auto operator()(BenchFixture& f) const {
+        return fibo_heap_dijkstra(*f.csr_graph, f.src, f.nodes_count);
     }
 };
 
 struct BoostDijkstraAlgo {
-    auto operator()(Graph& g, int s, int64_t n) const {
-        return boost_dijkstra(g, s, n);
+    auto operator()(BenchFixture& f) const {
+        return boost_dijkstra(*f.graph, f.src, f.nodes_count);
     }
 };
 
 struct BMSSPAlgo {
-    auto operator()(Graph& g, int s, int64_t n) const {
-        return top_level_BMSSP(g, s, n);
+    auto operator()(BenchFixture& f) const {
+        return top_level_BMSSP(*f.csr_graph, f.src, f.nodes_count);
+    }
+};
+
+template<typename State>
+struct BMSSPWorkspaceAlgoT {
+    unique_ptr<State> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<State>(*f.csr_graph);
+        }
+        return BMSSP_query(*state, f.src, f.nodes_count);
+    }
+
+    size_t peak_heap_size() const { return state ? state->base_case_queue.peak_size() : 0; }
+};
+
+// the workspace BMSSP with the fixture's bmssp_params
+struct BMSSPParamsAlgo : BMSSPWorkspaceAlgoT<BMSSP_State> {
+    auto operator()(BenchFixture& f) {
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<BMSSP_State>(*f.csr_graph);
+        }
+        state->params = f.bmssp_params;
+        return BMSSP_query(*state, f.src, f.nodes_count);
+    }
+};
+
+using BMSSPWorkspaceAlgo = BMSSPWorkspaceAlgoT<BMSSP_State>;
+using BMSSPSoAWorkspaceAlgo = BMSSPWorkspaceAlgoT<SoA_BMSSP_State>;
+using BMSSPPooledWorkspaceAlgo = BMSSPWorkspaceAlgoT<Pooled_BMSSP_State>;
+using BMSSPIndexedHeapWorkspaceAlgo = BMSSPWorkspaceAlgoT<Indexed_Heap_BMSSP_State>;
+
+/**
+ * The engines on a copy of the fixture's graph with Weight weights, made by prepare() once per graph out of the timings
+ */
+template<typename Weight>
+struct TypedGraphAlgo {
+    const CSR_Graph *source = nullptr;
+    unique_ptr<Basic_CSR_Graph<Weight>> graph;
+    bool fits = false;
+
+    // false when the fixture's weights don't convert exactly to Weight
+    bool prepare(BenchFixture& f) {
+        if (source != f.csr_graph) {
+            source = f.csr_graph;
+            fits = f.csr_graph->weights_fit<Weight>();
+            graph = fits ? make_unique<Basic_CSR_Graph<Weight>>(*f.csr_graph) : nullptr;
+        }
+        return fits;
+    }
+};
+
+template<typename State>
+struct TypedBMSSPAlgo : TypedGraphAlgo<typename State::Length_T> {
+    unique_ptr<State> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!state || state->graph_ptr != this->graph.get()) {
+            state = make_unique<State>(*this->graph);
+        }
+        return BMSSP_query(*state, f.src, f.nodes_count);
+    }
+
+    size_t peak_heap_size() const { return state ? state->base_case_queue.peak_size() : 0; }
+};
+
+template<typename Weight>
+struct TypedDijkstraAlgo : TypedGraphAlgo<Weight> {
+    unique_ptr<Basic_Dijkstra_State<Weight>> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!state || state->graph_ptr != this->graph.get()) {
+            state = make_unique<Basic_Dijkstra_State<Weight>>(*this->graph);
+        }
+        return dijkstra_query(*state, f.src, f.nodes_count);
     }
+
+    size_t peak_heap_size() const { return state ? state->peak_heap_size : 0; }
 };
 
+using BMSSPF32Algo = TypedBMSSPAlgo<F32_BMSSP_State>;
+using BMSSPU32Algo = TypedBMSSPAlgo<U32_BMSSP_State>;
+using DijkstraF32Algo = TypedDijkstraAlgo<float>;
+using DijkstraU32Algo = TypedDijkstraAlgo<uint32_t>;
+
+// largest heap of the last query for the algorithms that keep their heap in a workspace, -1 for the others
+template<typename AlgoT>
+auto peak_heap_size(const AlgoT &algo, int) -> decltype(static_cast<double>(algo.peak_heap_size())) {
+    return static_cast<double>(algo.peak_heap_size());
+}
+
+template<typename AlgoT>
+double peak_heap_size(const AlgoT &, long) {
+    return -1;
+}
+
+// setup of the algorithms out of the timed loop, false when they can't run on the fixture's graph
+template<typename AlgoT>
+auto prepare_algo(AlgoT &algo, BenchFixture &f, int) -> decltype(algo.prepare(f)) {
+    return algo.prepare(f);
+}
+
+template<typename AlgoT>
+bool prepare_algo(AlgoT &, BenchFixture &, long) {
+    return true;
+}
+
+// the distances of the engines templated on their weight type as Dist_T, infinity_of<Weight>() becomes INF
+template<typename Weight>
+vector<Dist_T> as_distances(const vector<Weight> &dist) {
+    vector<Dist_T> sortie; sortie.reserve(dist.size());
+    for (const Weight &d : dist) {
+        sortie.push_back(d == infinity_of<Weight>() ? INF : static_cast<Dist_T>(d));
+    }
+    return sortie;
+}
 
-template<typename GraphFixtureT, typename AlgoFunc>
+inline const vector<Dist_T> &as_distances(const vector<Dist_T> &dist) {
+    return dist;
+}
+
+
+/**
+ * Time of one query, multi-threaded algorithms read their thread count from the graph argument at THREADS_ARG
+ */
+template<typename GraphFixtureT, typename AlgoFunc, int THREADS_ARG = -1>
 class SSSPBench : public GraphFixtureT {
 public:
     AlgoFunc algo;
     void RunBenchmark(benchmark::State& st) {
+        this->threads = THREADS_ARG >= 0 ? st.range(THREADS_ARG) : 1;
+        if (!prepare_algo(algo, *this, 0)) {
+            st.SkipWithError("The weights of this graph don't fit the algorithm's weight type");
+            return;
+        }
+#ifdef BMSSP_COUNTERS
+        op_counters().reset();
+#endif
         for (auto _ : st) {
-            auto res = algo(*this->graph, this->src, this->nodes_count);
+            auto res = algo(*this);
 
             st.PauseTiming();
-            if (res.first != *this->ref_dist) {
-                for (int i=0; i<res.first.size(); i++) {
-                    if (res.first[i] != (*this->ref_dist)[i]) {
-                        cout << "Different at " << i << " " << (*this->ref_dist)[i] << " " << res.first[i] << endl;
+            const vector<Dist_T> &dist = as_distances(res.first);
+            if (dist != *this->ref_dist) {
+                for (int i=0; i<dist.size(); i++) {
+                    if (dist[i] != (*this->ref_dist)[i]) {
+                        cout << "Different at " << i << " " << (*this->ref_dist)[i] << " " << dist[i] << endl;
                     }
                 }
                 st.SkipWithError("Correctness check vs Boost Dijkstra failed!");
@@ -233,6 +516,356 @@ public:
         }
 
         st.SetComplexityN(this->nodes_count);
+        if (THREADS_ARG >= 0) {
+            st.counters["threads"] = this->threads;
+        }
+        if (peak_heap_size(algo, 0) >= 0) {
+            st.counters["peak_heap_size"] = peak_heap_size(algo, 0);
+        }
+        st.counters["nodes_count"] = this->nodes_count;
+        st.counters["edges_count"] = this->edges_count;
+#ifdef BMSSP_COUNTERS
+        // per run counts, the max_ ones over all the runs
+        op_counters().for_each([&](const char *name, uint64_t value) {
+            const bool is_max = strncmp(name, "max_", 4) == 0;
+            st.counters[name] = benchmark::Counter(value, is_max ? benchmark::Counter::kDefaults : benchmark::Counter::kAvgIterations);
+        });
+#endif
+    }
+};
+
+
+/**
+ * SSSPBench of BMSSP with the k, t, l and hybrid_cutoff read from the graph argument at PARAMS_ARG, see with_BMSSP_params
+ */
+template<typename GraphFixtureT, int PARAMS_ARG>
+class BMSSPParamSweepBench : public SSSPBench<GraphFixtureT, BMSSPParamsAlgo> {
+public:
+    void RunBenchmark(benchmark::State& st) {
+        this->bmssp_params = BMSSP_Params(st.range(PARAMS_ARG), st.range(PARAMS_ARG+1), st.range(PARAMS_ARG+2),
+                                          st.range(PARAMS_ARG+3));
+        SSSPBench<GraphFixtureT, BMSSPParamsAlgo>::RunBenchmark(st);
+
+        // the values used, with the minimal l when the requested one is too shallow
+        const BMSSP_Params used = this->bmssp_params.resolved(this->nodes_count);
+        st.counters["k"] = used.k;
+        st.counters["t"] = used.t;
+        st.counters["l"] = used.l;
+        st.counters["hybrid_cutoff"] = used.hybrid_cutoff;
+    }
+};
+
+
+struct BMSSPParallelPivotsAlgo {
+    unique_ptr<Thread_Pool> pool;
+    unique_ptr<BMSSP_State> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!pool || pool->size() != f.threads) {
+            pool = make_unique<Thread_Pool>(f.threads);
+            state = nullptr;
+        }
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<BMSSP_State>(*f.csr_graph);
+            state->enable_parallel_pivots(*pool);
+        }
+        return BMSSP_query(*state, f.src, f.nodes_count);
+    }
+};
+
+struct DeltaSteppingAlgo {
+    unique_ptr<Thread_Pool> pool;
+    unique_ptr<Delta_Stepping_State> state;
+
+    auto operator()(BenchFixture& f) {
+        if (!pool || pool->size() != f.threads) {
+            pool = make_unique<Thread_Pool>(f.threads);
+            state = nullptr;
+        }
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<Delta_Stepping_State>(*f.csr_graph, *pool);
+        }
+        return delta_stepping_query(*state, f.src, f.nodes_count);
+    }
+};
+
+struct BMSSPBatchAlgo {
+    using State = BMSSP_State;
+    static SSSP_Result query(State& state, Node_id_T s, int n) {
+        return BMSSP_query(state, s, n);
+    }
+};
+
+struct DijkstraBatchAlgo {
+    using State = Dijkstra_State;
+    static SSSP_Result query(State& state, Node_id_T s, int n) {
+        return dijkstra_query(state, s, n);
+    }
+};
+
+/**
+ * Throughput of batch_sssp, the thread count is the graph argument at THREADS_ARG
+ */
+template<typename GraphFixtureT, typename AlgoT, int THREADS_ARG>
+class BatchSSSPBench : public GraphFixtureT {
+public:
+    void RunBenchmark(benchmark::State& st) {
+        int threads = st.range(THREADS_ARG);
+        vector<Node_id_T> sources = {static_cast<Node_id_T>(this->src)};
+        mt19937 rng(RANDOM_SEED);
+        uniform_int_distribution<Node_id_T> dist(0, this->nodes_count-1);
+        while (sources.size() < BATCH_SOURCES_COUNT) {
+            sources.push_back(dist(rng));
+        }
+
+        Thread_Pool pool(threads);
+        for (auto _ : st) {
+            batch_sssp<typename AlgoT::State>(*this->csr_graph, sources, pool, AlgoT::query, [&](size_t idx, Node_id_T, SSSP_Result &res) {
+                if (idx == 0 && res.first != *this->ref_dist) {
+                    st.SkipWithError("Correctness check vs Boost Dijkstra failed!");
+                }
+                benchmark::DoNotOptimize(res);
+            });
+            benchmark::ClobberMemory();
+        }
+
+        st.counters["threads"] = threads;
+        st.counters["sources_count"] = sources.size();
+        st.counters["sources_per_second"] = benchmark::Counter(sources.size(), benchmark::Counter::kIsIterationInvariantRate);
+        st.counters["nodes_count"] = this->nodes_count;
+        st.counters["edges_count"] = this->edges_count;
+    }
+};
+
+
+struct BidirectionalDijkstraAlgo {
+    unique_ptr<Bidirectional_Dijkstra_State> state;
+
+    // the distance from s to t and the vertices settled to find it
+    pair<Dist_T, size_t> operator()(BenchFixture& f, Node_id_T s, Node_id_T t) {
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<Bidirectional_Dijkstra_State>(*f.csr_graph);
+        }
+        auto res = bidirectional_dijkstra_query(*state, s, t);
+        return {res.first, state->settled_count};
+    }
+};
+
+struct EarlyExitDijkstraAlgo {
+    unique_ptr<Bounded_Dijkstra_State> state;
+
+    pair<Dist_T, size_t> operator()(BenchFixture& f, Node_id_T s, Node_id_T t) {
+        if (!state || state->graph_ptr != f.csr_graph) {
+            state = make_unique<Bounded_Dijkstra_State>(*f.csr_graph);
+        }
+        Bounded_Query query;
+        query.targets = {t};
+        auto res = bounded_dijkstra_query(*state, s, query);
+        Dist_T d = !res.nodes.empty() && res.nodes.back() == t ? res.dist.back() : INF;
+        return {d, res.nodes.size()};
+    }
+};
+
+/**
+ * Time of ST_PAIRS_COUNT s-t queries between random vertices, the first pair starts at the fixture's source to be
+ * checked against Boost
+ */
+template<typename GraphFixtureT, typename AlgoT>
+class STQueryBench : public GraphFixtureT {
+public:
+    AlgoT algo;
+    void RunBenchmark(benchmark::State& st) {
+        mt19937 rng(RANDOM_SEED);
+        uniform_int_distribution<Node_id_T> dist(0, this->nodes_count-1);
+        vector<pair<Node_id_T, Node_id_T>> pairs = {{this->src, dist(rng)}};
+        while (pairs.size() < ST_PAIRS_COUNT) {
+            Node_id_T s = dist(rng);
+            pairs.emplace_back(s, dist(rng));
+        }
+
+        size_t settled = 0;
+        for (auto _ : st) {
+            settled = 0;
+            for (const auto &p : pairs) {
+                auto res = algo(*this, p.first, p.second);
+                settled += res.second;
+                benchmark::DoNotOptimize(res);
+            }
+            st.PauseTiming();
+            Dist_T expected = (*this->ref_dist)[pairs[0].second];
+            auto first = algo(*this, pairs[0].first, pairs[0].second);
+            if (abs(first.first - expected) > 1e-9 * expected) {
+                st.SkipWithError("Correctness check vs Boost Dijkstra failed!");
+            }
+            st.ResumeTiming();
+        }
+
+        st.counters["pairs_count"] = pairs.size();
+        st.counters["pairs_per_second"] = benchmark::Counter(pairs.size(), benchmark::Counter::kIsIterationInvariantRate);
+        st.counters["settled_per_query"] = static_cast<double>(settled) / pairs.size();
+        st.counters["nodes_count"] = this->nodes_count;
+        st.counters["edges_count"] = this->edges_count;
+    }
+};
+
+/**
+ * Time of dynamic_sssp_update on a batch of UPDATES_PER_BATCH random edges, half halved and half doubled. Each batch
+ * is reverted out of the timings so the tree must match Boost's again at the end, compare with the time of one query
+ * from scratch.
+ */
+template<typename GraphFixtureT>
+class DynamicSSSPBench : public GraphFixtureT {
+public:
+    void RunBenchmark(benchmark::State& st) {
+        Dynamic_SSSP_State state(*this->csr_graph, this->src, min_heap_dijkstra(*this->csr_graph, this->src, this->nodes_count));
+        mt19937 rng(RANDOM_SEED);
+        uniform_int_distribution<Node_id_T> pick(0, this->nodes_count-1);
+        vector<Edge_Update> batch, revert;
+        size_t changed = 0;
+
+        for (auto _ : st) {
+            st.PauseTiming();
+            batch.clear();
+            revert.clear();
+            while (batch.size() < UPDATES_PER_BATCH) {
+                Node_id_T u = pick(rng);
+                if (state.out[u].empty()) {
+                    continue;
+                }
+                Node_id_T v = state.out[u][rng() % state.out[u].size()].to;
+                Dist_T w = edge_weight(state, u, v);
+                batch.push_back({u, v, batch.size() % 2 ? w / 2 : w * 2});
+                revert.push_back({u, v, w});
+            }
+            reverse(revert.begin(), revert.end()); // the last update of an edge wins
+            st.ResumeTiming();
+
+            changed += dynamic_sssp_update(state, batch);
+
+            st.PauseTiming();
+            dynamic_sssp_update(state, revert);
+            st.ResumeTiming();
+        }
+
+        if (state.dist != *this->ref_dist) {
+            st.SkipWithError("Correctness check vs Boost Dijkstra failed!");
+        }
+        st.counters["updates_per_batch"] = UPDATES_PER_BATCH;
+        st.counters["changed_per_batch"] = benchmark::Counter(changed, benchmark::Counter::kAvgIterations);
+        st.counters["nodes_count"] = this->nodes_count;
+        st.counters["edges_count"] = this->edges_count;
+    }
+};
+
+
+struct ManyToManyAlgo {
+    static Distance_Matrix run(BenchFixture& f, const vector<Node_id_T>& sources, const vector<Node_id_T>& targets, Thread_Pool& pool) {
+        return many_to_many(*f.csr_graph, sources, targets, pool);
+    }
+};
+
+/**
+ * One full boost_dijkstra per source and a copy of the targets' distances, the sources spread over the same threads
+ */
+struct NaiveManyToManyAlgo {
+    static Distance_Matrix run(BenchFixture& f, const vector<Node_id_T>& sources, const vector<Node_id_T>& targets, Thread_Pool& pool) {
+        Distance_Matrix matrix(sources.size(), targets.size());
+        atomic<size_t> next{0};
+        pool.run([&](int) {
+            for (size_t i = next++; i < sources.size(); i = next++) {
+                Dist_List_T dist = boost_dijkstra(*f.graph, sources[i], f.nodes_count).first;
+                for (size_t j = 0; j < targets.size(); j++) {
+                    matrix.at(i, j) = dist[targets[j]];
+                }
+            }
+        });
+        return matrix;
+    }
+};
+
+/**
+ * Time of the distance matrix from MATRIX_SOURCES_COUNT to MATRIX_TARGETS_COUNT random vertices, the first source is
+ * the fixture's to be checked against Boost. The thread count is the graph argument at THREADS_ARG.
+ */
+template<typename GraphFixtureT, typename AlgoT, int THREADS_ARG>
+class ManyToManyBench : public GraphFixtureT {
+public:
+    void RunBenchmark(benchmark::State& st) {
+        int threads = st.range(THREADS_ARG);
+        mt19937 rng(RANDOM_SEED);
+        uniform_int_distribution<Node_id_T> pick(0, this->nodes_count-1);
+        vector<Node_id_T> sources = {static_cast<Node_id_T>(this->src)}, targets;
+        while (sources.size() < MATRIX_SOURCES_COUNT) {
+            sources.push_back(pick(rng));
+        }
+        while (targets.size() < MATRIX_TARGETS_COUNT) {
+            targets.push_back(pick(rng));
+        }
+
+        Thread_Pool pool(threads);
+        for (auto _ : st) {
+            Distance_Matrix matrix = AlgoT::run(*this, sources, targets, pool);
+            st.PauseTiming();
+            for (size_t j = 0; j < targets.size(); j++) {
+                if (matrix.at(0, j) != (*this->ref_dist)[targets[j]]) {
+                    st.SkipWithError("Correctness check vs Boost Dijkstra failed!");
+                    break;
+                }
+            }
+            st.ResumeTiming();
+            benchmark::DoNotOptimize(matrix);
+        }
+
+        st.counters["threads"] = threads;
+        st.counters["sources_count"] = sources.size();
+        st.counters["targets_count"] = targets.size();
+        st.counters["sources_per_second"] = benchmark::Counter(sources.size(), benchmark::Counter::kIsIterationInvariantRate);
+        st.counters["nodes_count"] = this->nodes_count;
+        st.counters["edges_count"] = this->edges_count;
+    }
+};
+
+
+/**
+ * Time of CACHED_QUERIES_COUNT queries through Cached_SSSP, 3 of 4 from one of CACHED_HUBS_COUNT hubs and the others
+ * from random vertices, starting from an empty cache of CACHED_RESULTS_BUDGET results. Compare the time per query with
+ * BMSSP's.
+ */
+template<typename GraphFixtureT>
+class CachedSSSPBench : public GraphFixtureT {
+public:
+    void RunBenchmark(benchmark::State& st) {
+        mt19937 rng(RANDOM_SEED);
+        uniform_int_distribution<Node_id_T> pick(0, this->nodes_count-1);
+        vector<Node_id_T> hubs = {static_cast<Node_id_T>(this->src)};
+        while (hubs.size() < CACHED_HUBS_COUNT) {
+            hubs.push_back(pick(rng));
+        }
+        vector<Node_id_T> queries;
+        while (queries.size() < CACHED_QUERIES_COUNT) {
+            queries.push_back(rng() % 4 ? hubs[rng() % hubs.size()] : pick(rng));
+        }
+
+        const size_t result_size = this->nodes_count * (sizeof(Dist_T) + sizeof(Node_id_T));
+        SSSP_Cache cache(CACHED_RESULTS_BUDGET * result_size);
+        Cached_SSSP cached(*this->csr_graph, cache);
+        for (auto _ : st) {
+            for (const Node_id_T &s : queries) {
+                benchmark::DoNotOptimize(cached.query(s));
+            }
+            st.PauseTiming();
+            if (cached.query(this->src)->first != *this->ref_dist) {
+                st.SkipWithError("Correctness check vs Boost Dijkstra failed!");
+            }
+            cache.clear();
+            st.ResumeTiming();
+        }
+
+        SSSP_Cache_Stats stats = cache.stats();
+        st.counters["queries_count"] = queries.size();
+        st.counters["queries_per_second"] = benchmark::Counter(queries.size(), benchmark::Counter::kIsIterationInvariantRate);
+        st.counters["hit_rate"] = stats.hit_rate();
+        st.counters["evictions"] = benchmark::Counter(stats.evictions, benchmark::Counter::kAvgIterations);
         st.counters["nodes_count"] = this->nodes_count;
         st.counters["edges_count"] = this->edges_count;
     }
@@ -241,27 +874,112 @@ public:
 
 // Random weighted
 using StdPQ_RandomGraph = SSSPBench<RandomGraphFixture, StdPQDijkstraAlgo>;
+using BinaryHeapWorkspace_RandomGraph = SSSPBench<RandomGraphFixture, DijkstraWorkspaceAlgo>;
+using IndexedHeap_RandomGraph = SSSPBench<RandomGraphFixture, IndexedHeapDijkstraAlgo<4>>;
 using Fibo_RandomGraph = SSSPBench<RandomGraphFixture, FiboDijkstraAlgo>;
 using Boost_RandomGraph = SSSPBench<RandomGraphFixture, BoostDijkstraAlgo>;
+using DeltaStepping_RandomGraph = SSSPBench<RandomGraphFixture, DeltaSteppingAlgo, 2>;
 using BMSSP_RandomGraph = SSSPBench<RandomGraphFixture, BMSSPAlgo>;
+using BMSSPWorkspace_RandomGraph = SSSPBench<RandomGraphFixture, BMSSPWorkspaceAlgo>;
+using BMSSPSoAWorkspace_RandomGraph = SSSPBench<RandomGraphFixture, BMSSPSoAWorkspaceAlgo>;
+using BMSSPPooledWorkspace_RandomGraph = SSSPBench<RandomGraphFixture, BMSSPPooledWorkspaceAlgo>;
+using BMSSPIndexedHeapWorkspace_RandomGraph = SSSPBench<RandomGraphFixture, BMSSPIndexedHeapWorkspaceAlgo>;
 
 // Random unweighted
 using StdPQ_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, StdPQDijkstraAlgo>;
+using BinaryHeapWorkspace_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, DijkstraWorkspaceAlgo>;
+using IndexedHeap_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, IndexedHeapDijkstraAlgo<4>>;
+using Bucket_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BucketDijkstraAlgo>;
 using Fibo_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, FiboDijkstraAlgo>;
 using Boost_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BoostDijkstraAlgo>;
+using DeltaStepping_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, DeltaSteppingAlgo, 2>;
 using BMSSP_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPAlgo>;
+using BMSSPWorkspace_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPWorkspaceAlgo>;
+using BMSSPSoAWorkspace_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPSoAWorkspaceAlgo>;
+using BMSSPPooledWorkspace_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPPooledWorkspaceAlgo>;
+using BMSSPIndexedHeapWorkspace_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPIndexedHeapWorkspaceAlgo>;
 
 // Grid
 using StdPQ_Grid = SSSPBench<GridGraphFixture, StdPQDijkstraAlgo>;
+using BinaryHeapWorkspace_Grid = SSSPBench<GridGraphFixture, DijkstraWorkspaceAlgo>;
+using IndexedHeap_Grid = SSSPBench<GridGraphFixture, IndexedHeapDijkstraAlgo<4>>;
+using Bucket_Grid = SSSPBench<GridGraphFixture, BucketDijkstraAlgo>;
 using Fibo_Grid = SSSPBench<GridGraphFixture, FiboDijkstraAlgo>;
 using Boost_Grid = SSSPBench<GridGraphFixture, BoostDijkstraAlgo>;
+using DeltaStepping_Grid = SSSPBench<GridGraphFixture, DeltaSteppingAlgo, 2>;
 using BMSSP_Grid = SSSPBench<GridGraphFixture, BMSSPAlgo>;
+using BMSSPWorkspace_Grid = SSSPBench<GridGraphFixture, BMSSPWorkspaceAlgo>;
+using BMSSPSoAWorkspace_Grid = SSSPBench<GridGraphFixture, BMSSPSoAWorkspaceAlgo>;
+using BMSSPPooledWorkspace_Grid = SSSPBench<GridGraphFixture, BMSSPPooledWorkspaceAlgo>;
+using BMSSPIndexedHeapWorkspace_Grid = SSSPBench<GridGraphFixture, BMSSPIndexedHeapWorkspaceAlgo>;
 
 // BGP graphs
 using StdPQ_BGP = SSSPBench<BGPGraphFixture, StdPQDijkstraAlgo>;
+using BinaryHeapWorkspace_BGP = SSSPBench<BGPGraphFixture, DijkstraWorkspaceAlgo>;
+using IndexedHeap_BGP = SSSPBench<BGPGraphFixture, IndexedHeapDijkstraAlgo<4>>;
 using Fibo_BGP = SSSPBench<BGPGraphFixture, FiboDijkstraAlgo>;
 using Boost_BGP = SSSPBench<BGPGraphFixture, BoostDijkstraAlgo>;
+using DeltaStepping_BGP = SSSPBench<BGPGraphFixture, DeltaSteppingAlgo, 1>;
 using BMSSP_BGP = SSSPBench<BGPGraphFixture, BMSSPAlgo>;
+using BMSSPWorkspace_BGP = SSSPBench<BGPGraphFixture, BMSSPWorkspaceAlgo>;
+using BMSSPSoAWorkspace_BGP = SSSPBench<BGPGraphFixture, BMSSPSoAWorkspaceAlgo>;
+using BMSSPPooledWorkspace_BGP = SSSPBench<BGPGraphFixture, BMSSPPooledWorkspaceAlgo>;
+using BMSSPIndexedHeapWorkspace_BGP = SSSPBench<BGPGraphFixture, BMSSPIndexedHeapWorkspaceAlgo>;
+
+// 32 bits weights and distances
+using BMSSPF32_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPF32Algo>;
+using BMSSPU32_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, BMSSPU32Algo>;
+using DijkstraF32_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, DijkstraF32Algo>;
+using DijkstraU32_RandomUnweighted = SSSPBench<RandomUnweightedGraphFixture, DijkstraU32Algo>;
+using BMSSPF32_Grid = SSSPBench<GridGraphFixture, BMSSPF32Algo>;
+using BMSSPU32_Grid = SSSPBench<GridGraphFixture, BMSSPU32Algo>;
+using DijkstraF32_Grid = SSSPBench<GridGraphFixture, DijkstraF32Algo>;
+using DijkstraU32_Grid = SSSPBench<GridGraphFixture, DijkstraU32Algo>;
+using BMSSPF32_BGP = SSSPBench<BGPGraphFixture, BMSSPF32Algo>;
+using BMSSPU32_BGP = SSSPBench<BGPGraphFixture, BMSSPU32Algo>;
+using DijkstraF32_BGP = SSSPBench<BGPGraphFixture, DijkstraF32Algo>;
+using DijkstraU32_BGP = SSSPBench<BGPGraphFixture, DijkstraU32Algo>;
+
+// BMSSP parameter sweep
+using BMSSPParams_RandomGraph = BMSSPParamSweepBench<RandomGraphFixture, 2>;
+using BMSSPParams_Grid = BMSSPParamSweepBench<GridGraphFixture, 2>;
+using BMSSPParams_BGP = BMSSPParamSweepBench<BGPGraphFixture, 1>;
+using BMSSPHybrid_RandomGraph = BMSSPParamSweepBench<RandomGraphFixture, 2>;
+using BMSSPHybrid_Grid = BMSSPParamSweepBench<GridGraphFixture, 2>;
+using BMSSPHybrid_BGP = BMSSPParamSweepBench<BGPGraphFixture, 1>;
+
+// Parallel find_pivots
+using BMSSPParallelPivots_RandomGraph = SSSPBench<RandomGraphFixture, BMSSPParallelPivotsAlgo, 2>;
+using BMSSPParallelPivots_BGP = SSSPBench<BGPGraphFixture, BMSSPParallelPivotsAlgo, 1>;
+
+// s-t queries
+using Bidirectional_RandomGraph = STQueryBench<RandomGraphFixture, BidirectionalDijkstraAlgo>;
+using EarlyExit_RandomGraph = STQueryBench<RandomGraphFixture, EarlyExitDijkstraAlgo>;
+using Bidirectional_Grid = STQueryBench<GridGraphFixture, BidirectionalDijkstraAlgo>;
+using EarlyExit_Grid = STQueryBench<GridGraphFixture, EarlyExitDijkstraAlgo>;
+using Bidirectional_BGP = STQueryBench<BGPGraphFixture, BidirectionalDijkstraAlgo>;
+using EarlyExit_BGP = STQueryBench<BGPGraphFixture, EarlyExitDijkstraAlgo>;
+
+// Dynamic updates
+using DynamicSSSP_RandomGraph = DynamicSSSPBench<RandomGraphFixture>;
+using DynamicSSSP_Grid = DynamicSSSPBench<GridGraphFixture>;
+using DynamicSSSP_BGP = DynamicSSSPBench<BGPGraphFixture>;
+
+// Batches
+using BMSSPBatch_RandomGraph = BatchSSSPBench<RandomGraphFixture, BMSSPBatchAlgo, 2>;
+using DijkstraBatch_RandomGraph = BatchSSSPBench<RandomGraphFixture, DijkstraBatchAlgo, 2>;
+using BMSSPBatch_BGP = BatchSSSPBench<BGPGraphFixture, BMSSPBatchAlgo, 1>;
+using DijkstraBatch_BGP = BatchSSSPBench<BGPGraphFixture, DijkstraBatchAlgo, 1>;
+
+// Distance matrices
+using ManyToMany_RandomGraph = ManyToManyBench<RandomGraphFixture, ManyToManyAlgo, 2>;
+using NaiveManyToMany_RandomGraph = ManyToManyBench<RandomGraphFixture, NaiveManyToManyAlgo, 2>;
+using ManyToMany_BGP = ManyToManyBench<BGPGraphFixture, ManyToManyAlgo, 1>;
+using NaiveManyToMany_BGP = ManyToManyBench<BGPGraphFixture, NaiveManyToManyAlgo, 1>;
+
+// Cached queries
+using CachedSSSP_RandomGraph = CachedSSSPBench<RandomGraphFixture>;
+using CachedSSSP_BGP = CachedSSSPBench<BGPGraphFixture>;
 
 
 #define DEFINE_BENCHMARK(Cls, Name) \
@@ -285,52 +1003,222 @@ for (int arg = 0; arg<N; arg++){ \
 
 // Random weighted
 DEFINE_BENCHMARK(StdPQ_RandomGraph, STDPriorityQueue)
+DEFINE_BENCHMARK(BinaryHeapWorkspace_RandomGraph, BinaryHeapWorkspace)
+DEFINE_BENCHMARK(IndexedHeap_RandomGraph, Indexed4aryHeap)
 DEFINE_BENCHMARK(Fibo_RandomGraph, BOOSTFibonacciHeap)
 DEFINE_BENCHMARK(Boost_RandomGraph, BOOSTDijkstra)
+DEFINE_BENCHMARK(DeltaStepping_RandomGraph, DeltaStepping)
 DEFINE_BENCHMARK(BMSSP_RandomGraph, BMSSP)
+DEFINE_BENCHMARK(BMSSPWorkspace_RandomGraph, BMSSPWorkspace)
+DEFINE_BENCHMARK(BMSSPSoAWorkspace_RandomGraph, BMSSPSoAWorkspace)
+DEFINE_BENCHMARK(BMSSPPooledWorkspace_RandomGraph, BMSSPPooledWorkspace)
+DEFINE_BENCHMARK(BMSSPIndexedHeapWorkspace_RandomGraph, BMSSPIndexedHeapWorkspace)
 
 // Random unweighted
 DEFINE_BENCHMARK(StdPQ_RandomUnweighted, STDPriorityQueue)
+DEFINE_BENCHMARK(BinaryHeapWorkspace_RandomUnweighted, BinaryHeapWorkspace)
+DEFINE_BENCHMARK(IndexedHeap_RandomUnweighted, Indexed4aryHeap)
+DEFINE_BENCHMARK(Bucket_RandomUnweighted, BucketQueue)
 DEFINE_BENCHMARK(Fibo_RandomUnweighted, BOOSTFibonacciHeap)
 DEFINE_BENCHMARK(Boost_RandomUnweighted, BOOSTDijkstra)
+DEFINE_BENCHMARK(DeltaStepping_RandomUnweighted, DeltaStepping)
 DEFINE_BENCHMARK(BMSSP_RandomUnweighted, BMSSP)
+DEFINE_BENCHMARK(BMSSPWorkspace_RandomUnweighted, BMSSPWorkspace)
+DEFINE_BENCHMARK(BMSSPSoAWorkspace_RandomUnweighted, BMSSPSoAWorkspace)
+DEFINE_BENCHMARK(BMSSPPooledWorkspace_RandomUnweighted, BMSSPPooledWorkspace)
+DEFINE_BENCHMARK(BMSSPIndexedHeapWorkspace_RandomUnweighted, BMSSPIndexedHeapWorkspace)
 
 // Grid
 DEFINE_BENCHMARK(StdPQ_Grid, STDPriorityQueue)
+DEFINE_BENCHMARK(BinaryHeapWorkspace_Grid, BinaryHeapWorkspace)
+DEFINE_BENCHMARK(IndexedHeap_Grid, Indexed4aryHeap)
+DEFINE_BENCHMARK(Bucket_Grid, BucketQueue)
 DEFINE_BENCHMARK(Fibo_Grid, BOOSTFibonacciHeap)
 DEFINE_BENCHMARK(Boost_Grid, BOOSTDijkstra)
+DEFINE_BENCHMARK(DeltaStepping_Grid, DeltaStepping)
 DEFINE_BENCHMARK(BMSSP_Grid, BMSSP)
+DEFINE_BENCHMARK(BMSSPWorkspace_Grid, BMSSPWorkspace)
+DEFINE_BENCHMARK(BMSSPSoAWorkspace_Grid, BMSSPSoAWorkspace)
+DEFINE_BENCHMARK(BMSSPPooledWorkspace_Grid, BMSSPPooledWorkspace)
+DEFINE_BENCHMARK(BMSSPIndexedHeapWorkspace_Grid, BMSSPIndexedHeapWorkspace)
 
 // BGP graphs
 DEFINE_BENCHMARK(StdPQ_BGP, STDPriorityQueue)
+DEFINE_BENCHMARK(BinaryHeapWorkspace_BGP, BinaryHeapWorkspace)
+DEFINE_BENCHMARK(IndexedHeap_BGP, Indexed4aryHeap)
 DEFINE_BENCHMARK(Fibo_BGP, BOOSTFibonacciHeap)
 DEFINE_BENCHMARK(Boost_BGP, BOOSTDijkstra)
+DEFINE_BENCHMARK(DeltaStepping_BGP, DeltaStepping)
 DEFINE_BENCHMARK(BMSSP_BGP, BMSSP)
+DEFINE_BENCHMARK(BMSSPWorkspace_BGP, BMSSPWorkspace)
+DEFINE_BENCHMARK(BMSSPSoAWorkspace_BGP, BMSSPSoAWorkspace)
+DEFINE_BENCHMARK(BMSSPPooledWorkspace_BGP, BMSSPPooledWorkspace)
+DEFINE_BENCHMARK(BMSSPIndexedHeapWorkspace_BGP, BMSSPIndexedHeapWorkspace)
+
+// 32 bits weights and distances
+DEFINE_BENCHMARK(BMSSPF32_RandomUnweighted, BMSSPF32)
+DEFINE_BENCHMARK(BMSSPU32_RandomUnweighted, BMSSPU32)
+DEFINE_BENCHMARK(DijkstraF32_RandomUnweighted, DijkstraF32)
+DEFINE_BENCHMARK(DijkstraU32_RandomUnweighted, DijkstraU32)
+DEFINE_BENCHMARK(BMSSPF32_Grid, BMSSPF32)
+DEFINE_BENCHMARK(BMSSPU32_Grid, BMSSPU32)
+DEFINE_BENCHMARK(DijkstraF32_Grid, DijkstraF32)
+DEFINE_BENCHMARK(DijkstraU32_Grid, DijkstraU32)
+DEFINE_BENCHMARK(BMSSPF32_BGP, BMSSPF32)
+DEFINE_BENCHMARK(BMSSPU32_BGP, BMSSPU32)
+DEFINE_BENCHMARK(DijkstraF32_BGP, DijkstraF32)
+DEFINE_BENCHMARK(DijkstraU32_BGP, DijkstraU32)
+
+// BMSSP parameter sweep
+DEFINE_BENCHMARK(BMSSPParams_RandomGraph, BMSSPParams)
+DEFINE_BENCHMARK(BMSSPParams_Grid, BMSSPParams)
+DEFINE_BENCHMARK(BMSSPParams_BGP, BMSSPParams)
+DEFINE_BENCHMARK(BMSSPHybrid_RandomGraph, BMSSPHybrid)
+DEFINE_BENCHMARK(BMSSPHybrid_Grid, BMSSPHybrid)
+DEFINE_BENCHMARK(BMSSPHybrid_BGP, BMSSPHybrid)
+
+// Parallel find_pivots
+DEFINE_BENCHMARK(BMSSPParallelPivots_RandomGraph, BMSSPParallelPivots)
+DEFINE_BENCHMARK(BMSSPParallelPivots_BGP, BMSSPParallelPivots)
+
+// s-t queries
+DEFINE_BENCHMARK(Bidirectional_RandomGraph, BidirectionalDijkstra)
+DEFINE_BENCHMARK(EarlyExit_RandomGraph, EarlyExitDijkstra)
+DEFINE_BENCHMARK(Bidirectional_Grid, BidirectionalDijkstra)
+DEFINE_BENCHMARK(EarlyExit_Grid, EarlyExitDijkstra)
+DEFINE_BENCHMARK(Bidirectional_BGP, BidirectionalDijkstra)
+DEFINE_BENCHMARK(EarlyExit_BGP, EarlyExitDijkstra)
+
+// Dynamic updates
+DEFINE_BENCHMARK(DynamicSSSP_RandomGraph, DynamicSSSP)
+DEFINE_BENCHMARK(DynamicSSSP_Grid, DynamicSSSP)
+DEFINE_BENCHMARK(DynamicSSSP_BGP, DynamicSSSP)
+
+// Batches
+DEFINE_BENCHMARK(BMSSPBatch_RandomGraph, BMSSPBatch)
+DEFINE_BENCHMARK(DijkstraBatch_RandomGraph, DijkstraBatch)
+DEFINE_BENCHMARK(BMSSPBatch_BGP, BMSSPBatch)
+DEFINE_BENCHMARK(DijkstraBatch_BGP, DijkstraBatch)
+
+// Distance matrices
+DEFINE_BENCHMARK(ManyToMany_RandomGraph, ManyToMany)
+DEFINE_BENCHMARK(NaiveManyToMany_RandomGraph, NaiveManyToMany)
+DEFINE_BENCHMARK(ManyToMany_BGP, ManyToMany)
+DEFINE_BENCHMARK(NaiveManyToMany_BGP, NaiveManyToMany)
+
+// Cached queries
+DEFINE_BENCHMARK(CachedSSSP_RandomGraph, CachedSSSP)
+DEFINE_BENCHMARK(CachedSSSP_BGP, CachedSSSP)
 
 int main(int argc, char** argv) {
     // Random weighted
     REGISTER_BENCH_WITH_ARGS(StdPQ_RandomGraph, STDPriorityQueue, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BinaryHeapWorkspace_RandomGraph, BinaryHeapWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(IndexedHeap_RandomGraph, Indexed4aryHeap, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(Fibo_RandomGraph, BOOSTFibonacciHeap, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(Boost_RandomGraph, BOOSTDijkstra, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DeltaStepping_RandomGraph, DeltaStepping, parallel_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(BMSSP_RandomGraph, BMSSP, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPWorkspace_RandomGraph, BMSSPWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPSoAWorkspace_RandomGraph, BMSSPSoAWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPPooledWorkspace_RandomGraph, BMSSPPooledWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPIndexedHeapWorkspace_RandomGraph, BMSSPIndexedHeapWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
 
     // Random unweighted
     REGISTER_BENCH_WITH_ARGS(StdPQ_RandomUnweighted, STDPriorityQueue, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BinaryHeapWorkspace_RandomUnweighted, BinaryHeapWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(IndexedHeap_RandomUnweighted, Indexed4aryHeap, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(Bucket_RandomUnweighted, BucketQueue, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(Fibo_RandomUnweighted, BOOSTFibonacciHeap, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(Boost_RandomUnweighted, BOOSTDijkstra, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DeltaStepping_RandomUnweighted, DeltaStepping, parallel_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(BMSSP_RandomUnweighted, BMSSP, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPWorkspace_RandomUnweighted, BMSSPWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPSoAWorkspace_RandomUnweighted, BMSSPSoAWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPPooledWorkspace_RandomUnweighted, BMSSPPooledWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPIndexedHeapWorkspace_RandomUnweighted, BMSSPIndexedHeapWorkspace, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
 
     // Grid
     REGISTER_BENCH_WITH_ARGS(StdPQ_Grid, STDPriorityQueue, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BinaryHeapWorkspace_Grid, BinaryHeapWorkspace, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(IndexedHeap_Grid, Indexed4aryHeap, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(Bucket_Grid, BucketQueue, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(Fibo_Grid, BOOSTFibonacciHeap, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(Boost_Grid, BOOSTDijkstra, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DeltaStepping_Grid, DeltaStepping, parallel_grid_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_ARGS(BMSSP_Grid, BMSSP, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPWorkspace_Grid, BMSSPWorkspace, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPSoAWorkspace_Grid, BMSSPSoAWorkspace, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPPooledWorkspace_Grid, BMSSPPooledWorkspace, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPIndexedHeapWorkspace_Grid, BMSSPIndexedHeapWorkspace, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
 
     // BGP graphs
     REGISTER_BENCH_WITH_RANGE(StdPQ_BGP, STDPriorityQueue, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BinaryHeapWorkspace_BGP, BinaryHeapWorkspace, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(IndexedHeap_BGP, Indexed4aryHeap, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_RANGE(Fibo_BGP, BOOSTFibonacciHeap, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_RANGE(Boost_BGP, BOOSTDijkstra, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DeltaStepping_BGP, DeltaStepping, threaded_BGP_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
     REGISTER_BENCH_WITH_RANGE(BMSSP_BGP, BMSSP, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BMSSPWorkspace_BGP, BMSSPWorkspace, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BMSSPSoAWorkspace_BGP, BMSSPSoAWorkspace, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BMSSPPooledWorkspace_BGP, BMSSPPooledWorkspace, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BMSSPIndexedHeapWorkspace_BGP, BMSSPIndexedHeapWorkspace, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+
+    // 32 bits weights and distances, compare with BMSSPWorkspace and BinaryHeapWorkspace
+    REGISTER_BENCH_WITH_ARGS(BMSSPF32_RandomUnweighted, BMSSPF32, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPU32_RandomUnweighted, BMSSPU32, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DijkstraF32_RandomUnweighted, DijkstraF32, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DijkstraU32_RandomUnweighted, DijkstraU32, random_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPF32_Grid, BMSSPF32, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPU32_Grid, BMSSPU32, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DijkstraF32_Grid, DijkstraF32, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DijkstraU32_Grid, DijkstraU32, grid_ARGS)->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BMSSPF32_BGP, BMSSPF32, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(BMSSPU32_BGP, BMSSPU32, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(DijkstraF32_BGP, DijkstraF32, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(DijkstraU32_BGP, DijkstraU32, FILES.size())->Complexity()->Unit(benchmark::kMillisecond);
+
+    // BMSSP parameter sweep
+    REGISTER_BENCH_WITH_ARGS(BMSSPParams_RandomGraph, BMSSPParams, params_random_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPParams_Grid, BMSSPParams, params_grid_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPParams_BGP, BMSSPParams, params_BGP_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPHybrid_RandomGraph, BMSSPHybrid, hybrid_random_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPHybrid_Grid, BMSSPHybrid, hybrid_grid_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPHybrid_BGP, BMSSPHybrid, hybrid_BGP_ARGS)->Unit(benchmark::kMillisecond);
+
+    // Parallel find_pivots
+    REGISTER_BENCH_WITH_ARGS(BMSSPParallelPivots_RandomGraph, BMSSPParallelPivots, parallel_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPParallelPivots_BGP, BMSSPParallelPivots, threaded_BGP_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+    // s-t queries
+    REGISTER_BENCH_WITH_ARGS(Bidirectional_RandomGraph, BidirectionalDijkstra, random_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(EarlyExit_RandomGraph, EarlyExitDijkstra, random_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(Bidirectional_Grid, BidirectionalDijkstra, grid_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(EarlyExit_Grid, EarlyExitDijkstra, grid_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(Bidirectional_BGP, BidirectionalDijkstra, FILES.size())->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(EarlyExit_BGP, EarlyExitDijkstra, FILES.size())->Unit(benchmark::kMillisecond);
+
+    // Dynamic updates
+    REGISTER_BENCH_WITH_ARGS(DynamicSSSP_RandomGraph, DynamicSSSP, random_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DynamicSSSP_Grid, DynamicSSSP, grid_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(DynamicSSSP_BGP, DynamicSSSP, FILES.size())->Unit(benchmark::kMillisecond);
+
+    // Batches
+    REGISTER_BENCH_WITH_ARGS(BMSSPBatch_RandomGraph, BMSSPBatch, batch_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DijkstraBatch_RandomGraph, DijkstraBatch, batch_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(BMSSPBatch_BGP, BMSSPBatch, threaded_BGP_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(DijkstraBatch_BGP, DijkstraBatch, threaded_BGP_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+    // Distance matrices
+    REGISTER_BENCH_WITH_ARGS(ManyToMany_RandomGraph, ManyToMany, batch_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(NaiveManyToMany_RandomGraph, NaiveManyToMany, batch_random_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(ManyToMany_BGP, ManyToMany, threaded_BGP_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_ARGS(NaiveManyToMany_BGP, NaiveManyToMany, threaded_BGP_ARGS)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+    // Cached queries
+    REGISTER_BENCH_WITH_ARGS(CachedSSSP_RandomGraph, CachedSSSP, random_ARGS)->Unit(benchmark::kMillisecond);
+    REGISTER_BENCH_WITH_RANGE(CachedSSSP_BGP, CachedSSSP, FILES.size())->Unit(benchmark::kMillisecond);
 
     benchmark::Initialize(&argc, argv);
     benchmark::RunSpecifiedBenchmarks();
@@ -8,13 +8,20 @@
 #include "../include/utils/file_utils.hpp"
 #include "../include/dijkstras.hpp"
 #include "../include/bmssp.hpp"
+#include "../include/bmssp_autotune.hpp"
+#include "../include/batch_sssp.hpp"
+#include "../include/delta_stepping.hpp"
+#include "../include/dynamic_sssp.hpp"
+#include "../include/utils/result_io.hpp"
 
 using namespace std;
 
 struct Runner {
     Graph graph;
+    CSR_Graph csr_graph;
     int N;
     Graph constant_degree_graph;
+    CSR_Graph constant_degree_csr_graph;
     Node_id_T src = 0;
     Dist_List_T prev_dist;
     bool verbose = true;
@@ -25,8 +32,10 @@ private:
         prev_dist.clear();
         graph = go_get_that_graph(specifications);
         N = boost::num_vertices(graph);
-        auto cd = constant_degree_transformation(graph, N);
-        constant_degree_graph = cd.first;
+        csr_graph = CSR_Graph(graph);
+        auto cd = constant_degree_transformation(csr_graph, max(1u, thread::hardware_concurrency()));
+        constant_degree_csr_graph = cd.graph;
+        constant_degree_graph = constant_degree_csr_graph.to_graph();
     }
 
     void printResults(Dist_List_T dist, Prev_List_T parent) {
@@ -62,8 +71,21 @@ private:
         pair<Dist_List_T, Prev_List_T> results = algo(g, src, N);
         chrono::duration<double, milli> time_span = chrono::high_resolution_clock::now() - t0;
 
+        return check_results(results, time_span.count());
+    }
+
+    pair<double, int> run_test(function<pair<Dist_List_T, Prev_List_T> (const CSR_Graph&, Node_id_T, int)> algo, bool use_cd = false) {
+        const CSR_Graph &g = use_cd ? constant_degree_csr_graph : csr_graph;
+
+        auto t0 = chrono::high_resolution_clock::now();
+        pair<Dist_List_T, Prev_List_T> results = algo(g, src, N);
+        chrono::duration<double, milli> time_span = chrono::high_resolution_clock::now() - t0;
+
+        return check_results(results, time_span.count());
+    }
+
+    pair<double, int> check_results(const pair<Dist_List_T, Prev_List_T> &results, double time_span_ms) {
         //printResults(results.first, results.second);
-        double time_span_ms = time_span.count();
         cout << "Time elapsed: " << time_span_ms << " ms" << endl;
 
         int mismatch = 0;
@@ -88,13 +110,33 @@ private:
     }
 
     void quicktest_helper() {
-        cout << "Min Heap Dijkstra" << endl; run_test(min_heap_dijkstra);
+        cout << "Min Heap Dijkstra" << endl; run_test(min_heap_dijkstra<Dist_T, Node_id_T>);
         verbose = true;
-        cout << "Fibo heap Dijkstra" << endl; run_test(fibo_heap_dijkstra);
+        cout << "Fibo heap Dijkstra" << endl; run_test(fibo_heap_dijkstra<Dist_T, Node_id_T>);
+        cout << "Bucket queue Dijkstra" << endl; run_test(bucket_dijkstra<Dist_T, Node_id_T>);
+        cout << "Indexed heap Dijkstra" << endl; run_test(indexed_heap_dijkstra<4, Dist_T, Node_id_T>);
         cout << "Boost Dijkstra" << endl; run_test(boost_dijkstra);
         //verbose = false;
         cout << "BMSSP" << endl; run_test(top_level_BMSSP);
         cout << "BMSSP CD" << endl; run_test(top_level_BMSSP, true);
+        cout << "BMSSP SoA paths" << endl; run_test(soa_top_level_BMSSP);
+        cout << "BMSSP pooled blocks" << endl; run_test(pooled_top_level_BMSSP);
+        cout << "BMSSP indexed heap" << endl; run_test(indexed_heap_top_level_BMSSP);
+        auto custom_bmssp = [](const CSR_Graph& g, Node_id_T s, int n) { return top_level_BMSSP_with_params(g, s, n, BMSSP_Params(1, 2)); };
+        cout << "BMSSP k=1 t=2" << endl; run_test(custom_bmssp);
+        auto hybrid_bmssp = [](const CSR_Graph& g, Node_id_T s, int n) { return top_level_BMSSP_with_params(g, s, n, BMSSP_Params(0, 0, 0, 1024)); };
+        cout << "BMSSP hybrid" << endl; run_test(hybrid_bmssp);
+
+        BMSSP_State state(csr_graph);
+        auto bmssp_query = [&state](const CSR_Graph&, Node_id_T s, int n) { return BMSSP_query(state, s, n); };
+        cout << "BMSSP reused state" << endl; run_test(bmssp_query);
+        cout << "BMSSP reused state again" << endl; run_test(bmssp_query);
+
+        auto parallel_bmssp = [](const CSR_Graph& g, Node_id_T s, int n) { return parallel_top_level_BMSSP(g, s, n, 4, 64); };
+        cout << "BMSSP parallel pivots" << endl; run_test(parallel_bmssp);
+
+        auto parallel_delta_stepping = [](const CSR_Graph& g, Node_id_T s, int n) { return delta_stepping(g, s, n, 0, 4); };
+        cout << "Delta-stepping" << endl; run_test(parallel_delta_stepping);
     }
 
     void avg_time_of_x_vertices_as_src_helper(int x, const string &title, const string &output){
@@ -116,10 +158,10 @@ private:
             last_boost_time = res.first;
             line += "\n Boost_dijkstra time: " + to_string(last_boost_time);
             boost_time += last_boost_time;
-            res = run_test(min_heap_dijkstra);
+            res = run_test(min_heap_dijkstra<Dist_T, Node_id_T>);
             line += "\n Min_heap_dijkstra time: " + to_string(res.first);
             min_heap_time += res.first;
-            res = run_test(fibo_heap_dijkstra);
+            res = run_test(fibo_heap_dijkstra<Dist_T, Node_id_T>);
             line += "\n Fibo_heap_dijkstra time: " + to_string(res.first);
             fibo_heap_time += res.first;
             res = run_test(top_level_BMSSP);
@@ -165,6 +207,152 @@ public:
         avg_time_of_x_vertices_as_src_helper(x, title, output);
     }
 
+    /**
+     * Compare the serial loop of avg_time_of_x_vertices_as_src with the batched API on the same x sources
+     * @param specifications graph's specs or graphml filepath
+     * @param x number of sources
+     * @param threads number of worker threads of the batch
+     */
+    void batch_of_x_vertices_as_src(const string& specifications, int x, int threads) {
+        cout << "=========== Batch of " << x << " sources on " << threads << " threads with graph specs: " << specifications << "===========>" << endl;
+        initialize(specifications);
+        vector<Node_id_T> sources; sources.reserve(x);
+        for (int i = 0; i < x; i++) {
+            sources.push_back(i % N);
+        }
+
+        auto timed = [](const function<vector<SSSP_Result>()> &f) {
+            auto t0 = chrono::high_resolution_clock::now();
+            vector<SSSP_Result> results = f();
+            chrono::duration<double, milli> time_span = chrono::high_resolution_clock::now() - t0;
+            return make_pair(results, time_span.count());
+        };
+
+        auto serial = timed([&]() {
+            vector<SSSP_Result> results;
+            for (const Node_id_T &s : sources) {
+                results.push_back(top_level_BMSSP(csr_graph, s, N));
+            }
+            return results;
+        });
+        cout << "Serial BMSSP: " << serial.second << " ms" << endl;
+
+        auto batch_bmssp = timed([&]() { return batch_sssp<BMSSP_State>(csr_graph, sources, threads, BMSSP_query<BMSSP_State>); });
+        cout << "Batch BMSSP: " << batch_bmssp.second << " ms, speedup: " << serial.second/batch_bmssp.second << endl;
+
+        auto batch_dijkstra = timed([&]() { return batch_sssp<Dijkstra_State>(csr_graph, sources, threads, dijkstra_query<Dist_T, Node_id_T>); });
+        cout << "Batch Dijkstra: " << batch_dijkstra.second << " ms" << endl;
+
+        for (int i = 0; i < x; i++) {
+            if (serial.first[i].first != batch_bmssp.first[i].first || serial.first[i].first != batch_dijkstra.first[i].first) {
+                throw runtime_error("Different results for source " + to_string(sources[i]));
+            }
+        }
+        cout << "Same results" << endl;
+    }
+
+    /**
+     * Find the fastest BMSSP parameters for the graph or read them from the parameters file when it was already tuned
+     * @param specifications graph's specs or graphml filepath
+     * @param x number of sources timed per candidate
+     * @param output parameters file, see bmssp_autotune.hpp
+     */
+    void tune_BMSSP_params(const string& specifications, int x, const string &output="bmssp_params.txt") {
+        cout << "=========== Tuning BMSSP on " << x << " sources with graph specs: " << specifications << "===========>" << endl;
+        initialize(specifications);
+        const BMSSP_Params paper = BMSSP_Params().resolved(N);
+        BMSSP_Tuning tuning = tuned_BMSSP_params(csr_graph, output, x);
+        cout << "Paper parameters: " << paper.to_string() << endl;
+        cout << "Tuned parameters: " << tuning.params.to_string() << ", " << tuning.ms_per_query << " ms per query" << endl;
+    }
+
+    /**
+     * Repair the shortest paths of src after batches of random edge reweights, insertions and deletions and compare
+     * with BMSSP from scratch on the updated graph
+     * @param specifications graph's specs or graphml filepath
+     * @param batches number of update batches
+     * @param batch_size updates per batch
+     */
+    void dynamic_updates(const string& specifications, int batches, int batch_size, int seed) {
+        cout << "=========== " << batches << " batches of " << batch_size << " edge updates with graph specs: " << specifications << "===========>" << endl;
+        initialize(specifications);
+        Dynamic_SSSP_State state(csr_graph, src, top_level_BMSSP(csr_graph, src, N));
+        mt19937 rng(seed);
+        uniform_int_distribution<Node_id_T> pick(0, N-1);
+        double update_ms = 0, scratch_ms = 0;
+        size_t changed = 0;
+
+        for (int b = 0; b < batches; b++) {
+            vector<Edge_Update> updates;
+            for (int i = 0; i < batch_size; i++) {
+                Node_id_T u = pick(rng);
+                if (i % 4 == 3 || state.out[u].empty()) { // an insertion
+                    updates.push_back({u, pick(rng), static_cast<Dist_T>(1 + rng() % 10)});
+                } else { // a deletion or a reweight
+                    Node_id_T v = state.out[u][rng() % state.out[u].size()].to;
+                    updates.push_back({u, v, i % 4 == 0 ? INF : static_cast<Dist_T>(1 + rng() % 10)});
+                }
+            }
+
+            auto t0 = chrono::high_resolution_clock::now();
+            changed += dynamic_sssp_update(state, updates);
+            auto t1 = chrono::high_resolution_clock::now();
+            CSR_Graph updated = state.to_csr_graph();
+            auto t2 = chrono::high_resolution_clock::now();
+            auto scratch = top_level_BMSSP(updated, src, updated.num_vertices());
+            auto t3 = chrono::high_resolution_clock::now();
+            update_ms += chrono::duration<double, milli>(t1 - t0).count();
+            scratch_ms += chrono::duration<double, milli>(t3 - t2).count();
+
+            if (scratch.first != state.dist) {
+                throw runtime_error("Different distances after the update batch " + to_string(b));
+            }
+        }
+        cout << "Dynamic updates: " << update_ms / batches << " ms per batch, " << static_cast<double>(changed) / batches
+             << " distances changed per batch" << endl;
+        cout << "BMSSP from scratch: " << scratch_ms / batches << " ms per batch" << endl;
+        cout << "Same results" << endl;
+    }
+
+    /**
+     * BMSSP from x random sources, each result written to a binary file by a background thread while the next query
+     * runs, then read back through the mapping
+     * @param specifications graph's specs or graphml filepath
+     * @param prefix the result of source s goes to prefix + s + ".bin"
+     * @param flags SSSP_RESULT_FLOAT_DISTANCES and SSSP_RESULT_DELTA_PARENTS, see result_io.hpp
+     */
+    void save_results(const string& specifications, int x, int seed, const string &prefix = "result_", uint32_t flags = SSSP_RESULT_DELTA_PARENTS) {
+        cout << "=========== Saving the results of " << x << " sources with graph specs: " << specifications << "===========>" << endl;
+        initialize(specifications);
+        mt19937 rng(seed);
+        uniform_int_distribution<Node_id_T> pick(0, N-1);
+        BMSSP_State state(csr_graph);
+        SSSP_Result_Writer writer(flags);
+        vector<pair<Node_id_T, SSSP_Result>> kept; // to check the files
+        double query_ms = 0;
+
+        auto t0 = chrono::high_resolution_clock::now();
+        for (int i = 0; i < x; i++) {
+            Node_id_T s = pick(rng);
+            auto t1 = chrono::high_resolution_clock::now();
+            SSSP_Result results = BMSSP_query(state, s, N);
+            query_ms += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - t1).count();
+            kept.emplace_back(s, results);
+            writer.write(prefix + to_string(s) + ".bin", s, move(results));
+        }
+        writer.wait();
+        chrono::duration<double, milli> total = chrono::high_resolution_clock::now() - t0;
+        cout << "Queries: " << query_ms / x << " ms per source, with the writes: " << total.count() / x << " ms per source" << endl;
+
+        for (const auto &k : kept) {
+            SSSP_Result_File file(prefix + to_string(k.first) + ".bin");
+            if (file.source() != k.first || file.parents() != k.second.second) {
+                throw runtime_error("Different results in " + prefix + to_string(k.first) + ".bin");
+            }
+        }
+        cout << "Same results" << endl;
+    }
+
     /**
      * Comparing on a lot of random graphs
      * @param N_max
@@ -181,9 +369,9 @@ public:
             auto res = run_test(boost_dijkstra);
             line += "\n Boost_dijkstra::  time: " + to_string(res.first) + "ms " + "mismatch: " + to_string(res.second);
             double boost_time = res.first;
-            res = run_test(min_heap_dijkstra);
+            res = run_test(min_heap_dijkstra<Dist_T, Node_id_T>);
             line += "\n Min_heap_dijkstra::  time: " + to_string(res.first) + "ms " + "mismatch: " + to_string(res.second);
-            res = run_test(fibo_heap_dijkstra);
+            res = run_test(fibo_heap_dijkstra<Dist_T, Node_id_T>);
             line += "\n Fibo_heap_dijkstra:: time: " + to_string(res.first) + "ms " + "mismatch: " + to_string(res.second);
             res = run_test(top_level_BMSSP);
             line += "\n BMSSP:: time: " + to_string(res.first) + "ms " + "mismatch: " + to_string(res.second);
@@ -12,7 +12,11 @@
 #include <boost/unordered/unordered_flat_map.hpp>
 #include <memory>
 #include <boost/sort/spreadsort/spreadsort.hpp>
-#define INF 10000000
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+#include "../include/utils/op_counters.hpp"
 
 using namespace std;
 
@@ -60,6 +64,148 @@ struct Block {
     }
 };
 
+/**
+ * Upper and lower bound of the values, numeric_limits for the arithmetic types, Value::infinity() and Value::lowest()
+ * otherwise
+ */
+template<typename Value, bool = is_arithmetic<Value>::value>
+struct Value_Bounds {
+    static Value infinity() {
+        return numeric_limits<Value>::has_infinity ? numeric_limits<Value>::infinity() : numeric_limits<Value>::max();
+    }
+    static Value lowest() { return numeric_limits<Value>::lowest(); }
+};
+
+template<typename Value>
+struct Value_Bounds<Value, false> {
+    static Value infinity() { return Value::infinity(); }
+    static Value lowest() { return Value::lowest(); }
+};
+
+/**
+ * Sparse side of the key maps: the dense slot of each key in [0, n), valid only when the key's stamp is the current
+ * generation. reset() starts a new generation so emptying the map is O(1), the buffer is only reallocated when n grows
+ * and its pages are only touched by the keys used.
+ */
+class Stamped_Index {
+    struct Entry {
+        uint32_t generation;
+        uint32_t slot;
+    };
+
+    vector<Entry> entries;
+    uint32_t generation = 0;
+
+public:
+    void reset(size_t n) {
+        if (n > entries.size()) {
+            entries.assign(n, Entry{0, 0});
+            generation = 0;
+        }
+        if (++generation == 0) { // wrapped around, old stamps could be mistaken for the current one
+            fill(entries.begin(), entries.end(), Entry{0, 0});
+            generation = 1;
+        }
+    }
+
+    bool contains(size_t key) const { return entries[key].generation == generation; }
+    size_t slot(size_t key) const { return entries[key].slot; }
+    void set(size_t key, size_t slot) { entries[key] = Entry{generation, static_cast<uint32_t>(slot)}; }
+    void erase(size_t key) { entries[key].generation = 0; }
+};
+
+/**
+ * Key map of the block lists: the block and the index in the block of each key. The dense side only grows to the
+ * largest number of keys held at once.
+ * @tparam Location where an item lives, e.g. (block, index in the block)
+ */
+template<typename Key, typename Location>
+struct Block_Key_Map {
+    Stamped_Index sparse;
+    vector<Key> dense;
+    vector<Location> values;
+
+    // empty map over the keys [0, n), the buffers are kept
+    void reset(size_t n) {
+        sparse.reset(n);
+        dense.clear();
+        values.clear();
+    }
+
+    bool contains(Key key) {
+        return sparse.contains(key);
+    }
+
+    void update(Key key, Location value) {
+        values[sparse.slot(key)] = value;
+    }
+
+    void insert(Key key, Location value) {
+        sparse.set(key, dense.size());
+        dense.push_back(key);
+        values.push_back(value);
+    }
+
+    void erase(Key key) {
+        size_t idx = sparse.slot(key);
+
+        Key &last_key = dense.back();
+        sparse.set(last_key, idx);
+        dense[idx] = last_key;
+        values[idx] = values.back();
+
+        dense.pop_back();
+        values.pop_back();
+        sparse.erase(key);
+    }
+
+    Location operator[](Key key) {
+        return values[sparse.slot(key)];
+    }
+};
+
+/**
+ * Splits L around its median values until each part fits in block_size, the parts are appended to sortie in
+ * increasing values
+ */
+template<typename Key, typename Value>
+void blocks_content_by_median(vector<vector<pair<Key, Value>>> &sortie, vector<pair<Key, Value>> &L, int block_size) {
+    using Item = pair<Key, Value>;
+    if (L.empty()) {
+        throw invalid_argument("L is not supposed to be empty check comparison or inputs");
+    }
+    if (static_cast<int>(L.size()) <= block_size) {
+        sortie.push_back(L);
+        return;
+    }
+
+    int mid = static_cast<int>(L.size())/2;
+    nth_element(L.begin(), L.begin()+mid, L.end(), [](auto &a, auto &b) {
+        return a.second < b.second;
+    });
+    Value median_val = L[mid].second;
+    vector<Item> left_block; left_block.reserve(mid+1);
+    vector<Item> right_block; right_block.reserve(mid+2);
+    for (const auto &p : L) {
+        if (p.second < median_val) {
+            left_block.push_back(p);
+        } else {
+            right_block.push_back(p);
+        }
+    }
+
+    if (left_block.empty()) {
+        left_block.push_back(right_block.front());
+        right_block.erase(right_block.begin());
+    } else if (right_block.empty()) {
+        right_block.push_back(left_block.back());
+        left_block.pop_back();
+    }
+
+    blocks_content_by_median(sortie, left_block, block_size);
+    blocks_content_by_median(sortie, right_block, block_size);
+}
+
 template<typename T>
 struct is_int_like: integral_constant<bool, is_integral<T>::value>{};
 
@@ -87,56 +233,7 @@ class BBL_DS {
         }
     };
 
-    struct KeyMap {
-        unique_ptr<size_t[]> sparse;
-        vector<Key> dense;
-        vector<pair<BlockIt, size_t>> values;
-
-        KeyMap() = default;
-
-        explicit KeyMap(const size_t n) {
-            sparse.reset(new size_t[n]);
-            dense.reserve(n/2);
-            values.reserve(n/2);
-        }
-
-        bool contains(Key key) {
-            size_t idx = sparse[key];
-            return idx < dense.size() && dense[idx] == key;
-        }
-
-        void update(Key key, pair<BlockIt, size_t> value) {
-            size_t idx = sparse[key];
-            values[idx] = value;
-        }
-
-        void insert(Key key, pair<BlockIt, size_t> value) {
-            sparse[key] = dense.size();
-            dense.push_back(key);
-            values.push_back(value);
-        }
-
-        void erase(Key key) {
-            size_t idx = sparse[key];
-
-            Key &last_key = dense.back();
-            sparse[last_key] = idx;
-            dense[idx] = last_key;
-            values[idx] = values.back();
-
-            dense.pop_back();
-            values.pop_back();
-        }
-
-        pair<BlockIt, size_t> operator[](Key key) {
-            return values[sparse[key]];
-        }
-
-        void clear() {
-            dense.clear();
-            values.clear();
-        }
-    };
+    using KeyMap = Block_Key_Map<Key, pair<BlockIt, size_t>>;
 
 private:
     int M;
@@ -168,7 +265,7 @@ private:
     }
 
     void block_batch_insert(vector<Item> &L, BlockIt block_it, bool update_ub=false) {
-        Value ub = Value(-1*INF);
+        Value ub = Value_Bounds<Value>::lowest();
         for (const auto &p : L) {
             size_t idx = block_it->insert(p);
             if (block_it->location == BlockT::Location::D1) {
@@ -185,6 +282,7 @@ private:
     }
 
     void split_D1_block(BlockIt block_it) {
+        COUNT_OP(ds_splits);
         int block_size = M/2 + 1;
         vector<vector<Item>> blocks; blocks.reserve(block_it->items.size()/block_size + 1);
         blocks_content_by_median(blocks, block_it->items, block_size); // 2 blocks
@@ -208,43 +306,6 @@ private:
         register_block_in_RBT(block_it);
     }
 
-    void blocks_content_by_median(vector<vector<Item>> &sortie, vector<Item> &L, int block_size) {
-        if (L.empty()) {
-            throw invalid_argument("L is not supposed to be empty check comparison or inputs");
-        }
-        if (static_cast<int>(L.size()) <= block_size) {
-            sortie.push_back(L);
-            return;
-        }
-
-        int mid = static_cast<int>(L.size())/2;
-        nth_element(L.begin(), L.begin()+mid, L.end(), [](auto &a, auto &b) {
-            return a.second < b.second;
-        });
-        Value median_val = L[mid].second;
-        Key median_key = L[mid].first;
-        vector<Item> left_block; left_block.reserve(mid+1);
-        vector<Item> right_block; right_block.reserve(mid+2);
-        for (const auto &p : L) {
-            if (p.second < median_val) {
-                left_block.push_back(p);
-            } else {
-                right_block.push_back(p);
-            }
-        }
-
-        if (left_block.empty()) {
-            left_block.push_back(right_block.front());
-            right_block.erase(right_block.begin());
-        } else if (right_block.empty()) {
-            right_block.push_back(left_block.back());
-            left_block.pop_back();
-        }
-
-        blocks_content_by_median(sortie, left_block, block_size);
-        blocks_content_by_median(sortie, right_block, block_size);
-    }
-
     void delete_block(BlockIt &block_it) {
         if (block_it->location == BlockT::Location::D0) {
             D0.erase(block_it);
@@ -323,10 +384,13 @@ private:
 public:
     BBL_DS() = default;
 
+    /**
+     * Empties the structure for keys in [0, N), the key map keeps its buffers so reusing a BBL_DS doesn't allocate
+     */
     void initialize(int M, Value B, int N) {
         this->D0.clear();
         this->D1.clear();
-        this->map = KeyMap(N);
+        this->map.reset(N);
         this->rbtree_D1.clear();
 
         BlockT b(B, M+1);
@@ -349,6 +413,7 @@ public:
     }
 
     void insert_pair(const Item &p) {
+        COUNT_OP(ds_inserts);
         if (map.contains(p.first)) {
             auto val = map[p.first];
             Value &old_v = val.first->items[val.second].second;
@@ -376,6 +441,8 @@ public:
         if (L.empty()) {
             return;
         }
+        COUNT_OP(ds_batch_prepends);
+        COUNT_OP_N(ds_prepended_pairs, L.size());
 
         // handle duplicates and existing
         vector<Item> cleaned_L; cleaned_L.reserve(L.size());
@@ -437,6 +504,7 @@ public:
             block_it->location = BlockT::Location::D0;
             block_batch_insert(blocks[i], block_it);
         }
+        COUNT_OP_MAX(max_D0_blocks, D0.size());
     }
 
     // collect the M smallest values from union(D0, D1)
@@ -448,6 +516,9 @@ public:
         fill_buffer_for_pull(buffer, D1);
 
         int n = static_cast<int>(buffer.size());
+        COUNT_OP(ds_pulls);
+        COUNT_OP_N(ds_pull_buffer_pairs, n);
+        COUNT_OP_MAX(max_pull_buffer, n);
 
         if (n <= M) {
             for (const auto &p : buffer) {
@@ -457,8 +528,8 @@ public:
             if (total_pairs() <= 0) { //if we removed all
                 x = B;
             }else {
-                Value x0 = !is_block_sequence_empty(D0) ? D0.front().min_value(): Value(INF);
-                Value x1 = !is_block_sequence_empty(D1) ? D1.front().min_value() : Value(INF);
+                Value x0 = !is_block_sequence_empty(D0) ? D0.front().min_value(): Value_Bounds<Value>::infinity();
+                Value x1 = !is_block_sequence_empty(D1) ? D1.front().min_value() : Value_Bounds<Value>::infinity();
                 x = min(x0, x1);
             }
             return  keys;
@@ -472,8 +543,8 @@ public:
             delete_pair_from_keymap_by_key(buffer[i].first);
             keys.push_back(buffer[i].first);
         }
-        Value x0 = !is_block_sequence_empty(D0) ? D0.front().min_value(): Value(INF);
-        Value x1 = !is_block_sequence_empty(D1) ? D1.front().min_value() : Value(INF);
+        Value x0 = !is_block_sequence_empty(D0) ? D0.front().min_value(): Value_Bounds<Value>::infinity();
+        Value x1 = !is_block_sequence_empty(D1) ? D1.front().min_value() : Value_Bounds<Value>::infinity();
         x = min(x0, x1);
         return keys;
     }
@@ -0,0 +1,140 @@
+/*
+ * Min d-ary heap over the items 0..n-1, each item is at most once in the heap and a position map gives
+ * decrease-key, so there are no stale entries. D children per node: a wider heap is shallower, sift-downs compare
+ * more keys but they sit in the same cache lines.
+ */
+
+#ifndef INDEXED_DARY_HEAP_HPP
+#define INDEXED_DARY_HEAP_HPP
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+
+template <typename Key, int D = 4, typename Compare = less<Key>>
+class Indexed_DAry_Heap {
+    static_assert(D >= 2, "a heap needs at least 2 children per node");
+
+    struct Entry {
+        Key key;
+        int item;
+    };
+
+    enum : int { ABSENT = -1 };
+
+public:
+    Indexed_DAry_Heap() = default;
+
+    explicit Indexed_DAry_Heap(int n) {
+        assign(n);
+    }
+
+    // items are 0..n-1, the heap is emptied
+    void assign(int n) {
+        heap.clear();
+        position.assign(n, ABSENT);
+        peak = 0;
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(int item) const { return position[item] != ABSENT; }
+    const Key &key(int item) const { return heap[position[item]].key; }
+
+    // largest size since the last assign or reset_peak
+    size_t peak_size() const { return peak; }
+    void reset_peak() { peak = heap.size(); }
+
+    /**
+     * Inserts item or lowers its key
+     * @return false when item was already in the heap with a key not greater than key
+     */
+    bool push_or_decrease(int item, const Key &key) {
+        int i = position[item];
+        if (i == ABSENT) {
+            i = static_cast<int>(heap.size());
+            heap.push_back({key, item});
+            peak = max(peak, heap.size());
+        } else if (compare(key, heap[i].key)) {
+            heap[i].key = key;
+        } else {
+            return false;
+        }
+        sift_up(i);
+        return true;
+    }
+
+    int top() const { return heap.front().item; }
+    const Key &top_key() const { return heap.front().key; }
+
+    int pop() {
+        const int item = heap.front().item;
+        position[item] = ABSENT;
+        if (heap.size() > 1) {
+            heap.front() = heap.back();
+            heap.pop_back();
+            sift_down(0);
+        } else {
+            heap.pop_back();
+        }
+        return item;
+    }
+
+    // empties the heap in O(size)
+    void clear() {
+        for (const Entry &e : heap) {
+            position[e.item] = ABSENT;
+        }
+        heap.clear();
+    }
+
+private:
+    vector<Entry> heap;
+    vector<int> position; // index of the item in heap, ABSENT if not in it
+    size_t peak = 0;
+    Compare compare{};
+
+    void sift_up(int i) {
+        Entry e = heap[i];
+        while (i > 0) {
+            int p = (i - 1) / D;
+            if (!compare(e.key, heap[p].key)) {
+                break;
+            }
+            heap[i] = heap[p];
+            position[heap[i].item] = i;
+            i = p;
+        }
+        heap[i] = e;
+        position[e.item] = i;
+    }
+
+    void sift_down(int i) {
+        Entry e = heap[i];
+        const int n = static_cast<int>(heap.size());
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) {
+                break;
+            }
+            int best = first;
+            for (int c = first + 1; c < min(first + D, n); c++) {
+                if (compare(heap[c].key, heap[best].key)) {
+                    best = c;
+                }
+            }
+            if (!compare(heap[best].key, e.key)) {
+                break;
+            }
+            heap[i] = heap[best];
+            position[heap[i].item] = i;
+            i = best;
+        }
+        heap[i] = e;
+        position[e.item] = i;
+    }
+};
+
+#endif //INDEXED_DARY_HEAP_HPP
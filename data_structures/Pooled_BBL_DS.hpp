@@ -0,0 +1,473 @@
+/*
+ * Same block-based linked list as BBL_DS but the blocks live in one pool: they are linked by index, their items are
+ * fixed-capacity slices of a single array and freed blocks are recycled through a free list.
+ * The D1 upper bounds are kept in a sorted flat array instead of a red-black tree.
+ * Once the pool is warm, splits, prepends and deletes don't allocate.
+ */
+
+#ifndef POOLED_BBL_DS_HPP
+#define POOLED_BBL_DS_HPP
+
+#include <vector>
+#include <algorithm>
+#include "BBL_DS.hpp"
+
+using namespace std;
+
+template <typename Key, typename Value>
+class Pooled_BBL_DS {
+
+    using Item = pair<Key, Value>;
+    using BlockT = Block<Key, Value>;
+    using Location = typename BlockT::Location;
+    using Block_id = int;
+
+    static constexpr Block_id NIL = -1;
+
+    struct Pool_Block {
+        Value upper_bound{};
+        Location location = BlockT::Location::UNK;
+        int size = 0;
+        Block_id prev = NIL;
+        Block_id next = NIL;
+    };
+
+    struct Block_Seq {
+        Block_id head = NIL;
+        Block_id tail = NIL;
+        int count = 0;
+    };
+
+    struct Bound {
+        Value upper_bound;
+        Block_id block;
+    };
+
+    using KeyMap = Block_Key_Map<Key, pair<Block_id, int>>;
+
+private:
+    int M = 0;
+    int capacity = 0; // items per block, a D1 block holds at most M+1 before its split
+    Value B{};
+    vector<Pool_Block> blocks;
+    vector<Item> slots; // items of block b are slots[b*capacity .. b*capacity + size)
+    vector<Block_id> free_blocks;
+    Block_Seq D0;  // Blocks from batch_prepend
+    Block_Seq D1;  // Blocks from regular insertions
+    vector<Bound> bounds_D1; // D1 upper bounds sorted, unique like the keys of a set
+
+    KeyMap map;
+    vector<Item> scratch;
+
+
+    Item *items_of(Block_id b) {
+        return slots.data() + static_cast<size_t>(b) * capacity;
+    }
+
+    Block_id allocate_block(Location loc) {
+        Block_id b;
+        if (!free_blocks.empty()) {
+            b = free_blocks.back();
+            free_blocks.pop_back();
+        } else {
+            b = static_cast<Block_id>(blocks.size());
+            blocks.emplace_back();
+            slots.resize(blocks.size() * capacity);
+        }
+        blocks[b] = Pool_Block();
+        blocks[b].location = loc;
+        return b;
+    }
+
+    // links b before pos, at the back when pos is NIL
+    void link_before(Block_Seq &seq, Block_id pos, Block_id b) {
+        Block_id prev = pos == NIL ? seq.tail : blocks[pos].prev;
+        blocks[b].prev = prev;
+        blocks[b].next = pos;
+        if (prev == NIL) {
+            seq.head = b;
+        } else {
+            blocks[prev].next = b;
+        }
+        if (pos == NIL) {
+            seq.tail = b;
+        } else {
+            blocks[pos].prev = b;
+        }
+        seq.count++;
+    }
+
+    void unlink(Block_Seq &seq, Block_id b) {
+        const Pool_Block &block = blocks[b];
+        if (block.prev == NIL) {
+            seq.head = block.next;
+        } else {
+            blocks[block.prev].next = block.next;
+        }
+        if (block.next == NIL) {
+            seq.tail = block.prev;
+        } else {
+            blocks[block.next].prev = block.prev;
+        }
+        seq.count--;
+        free_blocks.push_back(b);
+    }
+
+    typename vector<Bound>::iterator bound_lower_bound(const Value &value) {
+        return lower_bound(bounds_D1.begin(), bounds_D1.end(), value, [](const Bound &a, const Value &v) {
+            return a.upper_bound < v;
+        });
+    }
+
+    void register_block_in_index(Block_id b) {
+        auto it = bound_lower_bound(blocks[b].upper_bound);
+        if (it != bounds_D1.end() && !(blocks[b].upper_bound < it->upper_bound)) {
+            return; // equal bound already indexed
+        }
+        bounds_D1.insert(it, Bound{blocks[b].upper_bound, b});
+    }
+
+    void unregister_block_in_index(Block_id b) {
+        auto it = bound_lower_bound(blocks[b].upper_bound);
+        if (it != bounds_D1.end() && !(blocks[b].upper_bound < it->upper_bound)) {
+            bounds_D1.erase(it);
+        }
+    }
+
+    Block_id which_D1_block_for_value(Value value) {
+        auto it = bound_lower_bound(value);
+        if (it == bounds_D1.end()) {
+            return NIL;
+        }
+        return it->block;
+    }
+
+    int block_insert(Block_id b, const Item &p) {
+        int idx = blocks[b].size++;
+        items_of(b)[idx] = p;
+        return idx;
+    }
+
+    void block_batch_insert(const vector<Item> &L, Block_id b, bool update_ub=false) {
+        Value ub = Value_Bounds<Value>::lowest();
+        for (const auto &p : L) {
+            int idx = block_insert(b, p);
+            if (blocks[b].location == BlockT::Location::D1) {
+                // we are batch inserting in D1, so the key is already in the structure
+                map.update(p.first, {b, idx});
+            }else {
+                map.insert(p.first, {b, idx});
+            }
+            ub = max(ub, p.second);
+        }
+        if (update_ub) {
+            blocks[b].upper_bound = ub;
+        }
+    }
+
+    Value block_min_value(Block_id b) {
+        Item *items = items_of(b);
+        Value sortie = items[0].second;
+        for (int i = 1; i < blocks[b].size; i++) {
+            if (items[i].second < sortie) {
+                sortie = items[i].second;
+            }
+        }
+        return sortie;
+    }
+
+    void split_D1_block(Block_id b) {
+        COUNT_OP(ds_splits);
+        int block_size = M/2 + 1;
+        scratch.assign(items_of(b), items_of(b) + blocks[b].size);
+        vector<vector<Item>> parts; parts.reserve(scratch.size()/block_size + 1);
+        blocks_content_by_median(parts, scratch, block_size); // 2 blocks
+
+        if (parts.size() > 2) {
+            throw invalid_argument("/!\\ Split D1 block: more than 2 blocks" );
+        }
+
+        Block_id new_b = allocate_block(BlockT::Location::D1);
+        link_before(D1, b, new_b);
+
+        blocks[b].size = 0;
+        block_batch_insert(parts[0], new_b, true);
+        block_batch_insert(parts[1], b);
+
+        register_block_in_index(new_b);
+
+        // the second block with bigger values is already in D1
+        unregister_block_in_index(b);
+        register_block_in_index(b);
+    }
+
+    void delete_block(Block_id b) {
+        if (blocks[b].location == BlockT::Location::D0) {
+            unlink(D0, b);
+        } else {
+            if (blocks[b].upper_bound != B) {
+                unregister_block_in_index(b);
+                unlink(D1, b);
+            }else {
+                blocks[b].size = 0;
+            }
+        }
+    }
+
+    void delete_pair_from_keymap_by_key(Key key) {
+        auto val = map[key];
+        Block_id b = val.first;
+        int idx = val.second;
+        Item *items = items_of(b);
+
+        //delete
+        int last_idx = blocks[b].size-1;
+        if (idx != last_idx) {
+            //swap-pop for O(1), fix keymap after
+            swap(items[idx], items[last_idx]);
+            map.update(items[idx].first, {b, idx});
+        }
+        blocks[b].size--;
+        map.erase(key);
+
+        if (blocks[b].size == 0) {
+            delete_block(b);
+        }
+    }
+
+    void fill_buffer_for_pull(vector<Item> &buffer, const Block_Seq &sequence) {
+        int cpt = 0;
+        for (Block_id b = sequence.head; b != NIL && cpt < M; b = blocks[b].next) {
+            buffer.insert(buffer.end(), items_of(b), items_of(b) + blocks[b].size);
+            cpt += blocks[b].size;
+        }
+    }
+
+    bool is_block_sequence_empty(const Block_Seq &sequence) {
+        for (Block_id b = sequence.head; b != NIL; b = blocks[b].next) {
+            if (blocks[b].size > 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Block_id get_D0_block_position(const vector<Item> &block_content) {
+        Item maxi = block_content.front();
+        for (const auto &p : block_content) {
+            if (maxi.second < p.second) {
+                maxi = p;
+            }
+        }
+        for (Block_id b = D0.head; b != NIL; b = blocks[b].next) {
+            if (maxi.second < blocks[b].upper_bound) {
+                return b;
+            }
+        }
+        return NIL;
+    }
+
+    Value remaining_min_value() {
+        Value x0 = !is_block_sequence_empty(D0) ? block_min_value(D0.head) : Value_Bounds<Value>::infinity();
+        Value x1 = !is_block_sequence_empty(D1) ? block_min_value(D1.head) : Value_Bounds<Value>::infinity();
+        return min(x0, x1);
+    }
+
+    string value_as_string(Value v) {
+        ostringstream oss;
+        oss << v;
+        return oss.str();
+    }
+
+    vector<BlockT> copy_sequence(const Block_Seq &sequence) {
+        vector<BlockT> sortie;
+        for (Block_id b = sequence.head; b != NIL; b = blocks[b].next) {
+            BlockT block(blocks[b].upper_bound, blocks[b].location, blocks[b].size);
+            block.items.assign(items_of(b), items_of(b) + blocks[b].size);
+            sortie.push_back(move(block));
+        }
+        return sortie;
+    }
+
+public:
+    Pooled_BBL_DS() = default;
+
+    /**
+     * Same as BBL_DS::initialize, the pool and the key map keep their memory from the previous use
+     */
+    void initialize(int M, Value B, int N) {
+        if (M + 1 != capacity) {
+            blocks.clear();
+            slots.clear();
+        }
+        this->M = M;
+        this->capacity = M + 1;
+        this->B = B;
+
+        free_blocks.clear();
+        for (Block_id b = static_cast<Block_id>(blocks.size()) - 1; b >= 0; b--) {
+            free_blocks.push_back(b);
+        }
+        D0 = Block_Seq();
+        D1 = Block_Seq();
+        bounds_D1.clear();
+        this->map.reset(N);
+
+        Block_id b = allocate_block(BlockT::Location::D1);
+        blocks[b].upper_bound = B;
+        link_before(D1, NIL, b);
+        register_block_in_index(b);
+    }
+
+    void delete_pair(const Item &p){
+        if (!map.contains(p.first)) {
+            return;
+        }
+
+        delete_pair_from_keymap_by_key(p.first);
+    }
+
+    void insert_pair(const Item &p) {
+        COUNT_OP(ds_inserts);
+        if (map.contains(p.first)) {
+            auto val = map[p.first];
+            const Value &old_v = items_of(val.first)[val.second].second;
+            if (p.second < old_v) {
+                delete_pair_from_keymap_by_key(p.first);
+            } else {
+                return;
+            }
+        }
+
+        Block_id b = which_D1_block_for_value(p.second);
+        if (b == NIL) {
+            throw invalid_argument("Insert Pair: No existing block has ub >= value "+value_as_string(p.second));
+        }
+
+        int idx = block_insert(b, p);
+        map.insert(p.first, {b, idx});
+
+        if (blocks[b].size > M) {
+            split_D1_block(b);
+        }
+    }
+
+    void batch_prepend(vector<Item> &L) {
+        if (L.empty()) {
+            return;
+        }
+        COUNT_OP(ds_batch_prepends);
+        COUNT_OP_N(ds_prepended_pairs, L.size());
+
+        // handle duplicates and existing
+        vector<Item> cleaned_L; cleaned_L.reserve(L.size());
+
+        if(is_int_like<Key>::value) {
+            boost::sort::spreadsort::integer_sort(L.begin(), L.end(),[](const Item& x, unsigned shift) {
+                return static_cast<unsigned>(x.first) >> shift;
+            });
+        }else {
+            sort(L.begin(), L.end(), [](auto &a, auto &b) {
+                if (a.first != b.first) return a.first < b.first;
+                return a.second < b.second;
+            });
+        }
+
+        for (size_t i = 0; i < L.size(); ) {
+            size_t j = i + 1;
+            Value best = L[i].second;
+
+            while (j < L.size() && L[j].first == L[i].first) {
+                best = min(best, L[j].second);
+                ++j;
+            }
+
+            cleaned_L.emplace_back(L[i].first, best);
+            i = j;
+        }
+        L.clear(); L.swap(cleaned_L);
+
+        for (const auto &p: L) {
+            if (map.contains(p.first)) {
+                auto val = map[p.first];
+                const Value &old_v = items_of(val.first)[val.second].second;
+                if (p.second < old_v) {
+                    delete_pair_from_keymap_by_key(p.first);
+                }else {
+                    continue;
+                }
+            }
+            cleaned_L.push_back(p);
+        }
+
+        bool just_push_all = is_block_sequence_empty(D0);
+        int block_size = static_cast<int>(cleaned_L.size()) <= M ? M : (M+1)/2;
+        vector<vector<Item>> parts; parts.reserve(cleaned_L.size()/block_size + 1);
+        blocks_content_by_median(parts, cleaned_L, block_size);
+
+        for (int i = static_cast<int>(parts.size())-1; i >= 0; --i) {
+            Block_id pos = just_push_all ? D0.head : get_D0_block_position(parts[i]);
+            Block_id b = allocate_block(BlockT::Location::D0);
+            link_before(D0, pos, b);
+            block_batch_insert(parts[i], b);
+        }
+        COUNT_OP_MAX(max_D0_blocks, D0.count);
+    }
+
+    // collect the M smallest values from union(D0, D1)
+    vector<Key> pull(Value &x) {
+        vector<Item> buffer; buffer.reserve(4*M);
+        vector<Key> keys; keys.reserve(M);
+
+        fill_buffer_for_pull(buffer, D0);
+        fill_buffer_for_pull(buffer, D1);
+
+        int n = static_cast<int>(buffer.size());
+        COUNT_OP(ds_pulls);
+        COUNT_OP_N(ds_pull_buffer_pairs, n);
+        COUNT_OP_MAX(max_pull_buffer, n);
+
+        if (n <= M) {
+            for (const auto &p : buffer) {
+                delete_pair_from_keymap_by_key(p.first);
+                keys.push_back(p.first);
+            }
+            if (total_pairs() <= 0) { //if we removed all
+                x = B;
+            }else {
+                x = remaining_min_value();
+            }
+            return  keys;
+        }
+
+        nth_element(buffer.begin(), buffer.begin()+M, buffer.end(), [](auto &a, auto &b) {
+            return a.second < b.second;
+        });
+
+        for (int i = 0; i < M; i++) {
+            delete_pair_from_keymap_by_key(buffer[i].first);
+            keys.push_back(buffer[i].first);
+        }
+        x = remaining_min_value();
+        return keys;
+    }
+
+    int total_pairs() {
+        return map.dense.size();
+    }
+
+    bool empty() {
+        return total_pairs() == 0;
+    }
+
+    // copies of the D0 and D1 blocks in order, for inspection
+    pair<vector<BlockT>, vector<BlockT>> get_sequences() {
+        return {copy_sequence(D0), copy_sequence(D1)};
+    }
+
+    bool contains(Key key) {
+        return map.contains(key);
+    }
+};
+
+#endif //POOLED_BBL_DS_HPP
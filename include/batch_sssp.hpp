@@ -0,0 +1,65 @@
+#ifndef BATCH_SSSP_HPP
+#define BATCH_SSSP_HPP
+
+#include <atomic>
+#include <functional>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "utils/thread_pool.hpp"
+
+/*
+ * Many sources against one immutable graph: each worker thread owns one engine state (BMSSP_State, Dijkstra_State...)
+ * and reuses it for every source it picks up.
+ */
+
+using namespace std;
+
+/**
+ * Called once per source, from the worker thread that computed it: it must be thread-safe.
+ * The result can be moved out.
+ */
+using Batch_Callback = function<void(size_t idx, Node_id_T src, SSSP_Result &result)>;
+
+/**
+ * Runs query(state, src, N) for every source on the threads of pool and streams the results to callback
+ * @tparam State scratch memory of the engine, constructible from the graph, one per worker
+ * @param query engine entry point reusing a state, e.g. BMSSP_query or dijkstra_query
+ */
+template<typename State, typename Query>
+void batch_sssp(const CSR_Graph &g, const vector<Node_id_T> &sources, Thread_Pool &pool, Query query, const Batch_Callback &callback) {
+    const int N = g.num_vertices();
+    atomic<size_t> next{0};
+
+    pool.run([&](int) {
+        size_t i = next++;
+        if (i >= sources.size()) {
+            return;
+        }
+        State state(g); // built only by the workers that get some work
+
+        for (; i < sources.size(); i = next++) {
+            SSSP_Result result = query(state, sources[i], N);
+            callback(i, sources[i], result);
+        }
+    });
+}
+
+template<typename State, typename Query>
+void batch_sssp(const CSR_Graph &g, const vector<Node_id_T> &sources, int threads, Query query, const Batch_Callback &callback) {
+    Thread_Pool pool(min(threads, max(1, static_cast<int>(sources.size()))));
+    batch_sssp<State>(g, sources, pool, query, callback);
+}
+
+/**
+ * Same as above but keeps every result, results[i] belongs to sources[i]
+ */
+template<typename State, typename Query>
+vector<SSSP_Result> batch_sssp(const CSR_Graph &g, const vector<Node_id_T> &sources, int threads, Query query) {
+    vector<SSSP_Result> results(sources.size());
+    batch_sssp<State>(g, sources, threads, query, [&results](size_t idx, Node_id_T, SSSP_Result &result) {
+        results[idx] = move(result);
+    });
+    return results;
+}
+
+#endif //BATCH_SSSP_HPP
@@ -0,0 +1,153 @@
+#ifndef BIDIRECTIONAL_DIJKSTRA_HPP
+#define BIDIRECTIONAL_DIJKSTRA_HPP
+
+#include <vector>
+#include <algorithm>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "dijkstras.hpp"
+
+/*
+ * Bidirectional Dijkstra for s-t queries: a forward search from s on the graph and a backward one from t on its
+ * transpose. mu is the shortest s-t path seen where the searches meet, once the two heap tops add up to mu no
+ * shorter path can be found.
+ * src: https://en.wikipedia.org/wiki/Bidirectional_search
+ */
+
+using namespace std;
+
+/**
+ * One of the two searches, reset through the vertices it reached
+ */
+template<typename Weight, typename Id = Node_id_T>
+struct Search_Side {
+    vector<Weight> dist;
+    vector<Id> parent; // next vertex toward the search's origin
+    vector<Id> touched;
+    vector<Basic_Node<Weight, Id>> heap;
+
+    explicit Search_Side(int n) : dist(n, infinity_of<Weight>()), parent(n, -1) {}
+
+    void reset() {
+        for (const Id &v : touched) {
+            dist[v] = infinity_of<Weight>();
+            parent[v] = -1;
+        }
+        touched.clear();
+        heap.clear();
+    }
+
+    void start(Id origin) {
+        reset();
+        dist[origin] = 0;
+        touched.push_back(origin);
+        heap.push_back({origin, 0});
+    }
+
+    // drops the stale entries, infinity_of<Weight>() when the search is over
+    Weight top() {
+        while (!heap.empty() && heap.front().distance > dist[heap.front().name]) {
+            pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
+        }
+        return heap.empty() ? infinity_of<Weight>() : heap.front().distance;
+    }
+};
+
+/**
+ * Scratch memory of the bidirectional Dijkstra bound to one graph, the transpose is built once here and reused by
+ * every query
+ */
+template<typename Weight, typename Id = Node_id_T>
+struct Basic_Bidirectional_Dijkstra_State {
+    using Graph_T = Basic_CSR_Graph<Weight, Id>;
+    const Graph_T *graph_ptr;
+    Graph_T reverse;
+    Search_Side<Weight, Id> forward, backward;
+    size_t settled_count = 0; // by the last query, both sides
+
+    explicit Basic_Bidirectional_Dijkstra_State(const Graph_T &g) :
+        graph_ptr(&g), reverse(g.transpose()), forward(g.num_vertices()), backward(g.num_vertices()) {}
+};
+
+using Bidirectional_Dijkstra_State = Basic_Bidirectional_Dijkstra_State<Dist_T>;
+
+/**
+ * Settles the top vertex of side and relaxes its edges in g, mu and meet are updated where side meets other
+ */
+template<typename Weight, typename Id>
+void bidirectional_step(const Basic_CSR_Graph<Weight, Id> &g, Search_Side<Weight, Id> &side,
+                        const Search_Side<Weight, Id> &other, Weight &mu, Id &meet) {
+    pop_heap(side.heap.begin(), side.heap.end());
+    auto cur = side.heap.back();
+    side.heap.pop_back();
+
+    for (const auto &e : g.out_edges(cur.name)) {
+        Weight temp = saturating_add(cur.distance, e.w);
+        if (temp < side.dist[e.to]) {
+            if (side.dist[e.to] == infinity_of<Weight>()) {
+                side.touched.push_back(e.to);
+            }
+            side.dist[e.to] = temp;
+            side.parent[e.to] = cur.name;
+            side.heap.push_back({e.to, temp});
+            push_heap(side.heap.begin(), side.heap.end());
+            if (other.dist[e.to] < infinity_of<Weight>() && saturating_add(temp, other.dist[e.to]) < mu) {
+                mu = saturating_add(temp, other.dist[e.to]);
+                meet = e.to;
+            }
+        }
+    }
+}
+
+/**
+ * Shortest path from s to t, the side with fewer queued vertices advances first
+ * @return its length and its vertices from s to t, infinity_of<Weight>() and no vertex when t can't be reached
+ */
+template<typename Weight, typename Id>
+pair<Weight, vector<Id>> bidirectional_dijkstra_query(Basic_Bidirectional_Dijkstra_State<Weight, Id> &state, Id s, Id t) {
+    auto &forward = state.forward;
+    auto &backward = state.backward;
+    forward.start(s);
+    backward.start(t);
+    state.settled_count = 0;
+    Weight mu = s == t ? 0 : infinity_of<Weight>();
+    Id meet = s == t ? s : -1;
+
+    while (true) {
+        Weight top_f = forward.top(), top_b = backward.top();
+        if (top_f == infinity_of<Weight>() || top_b == infinity_of<Weight>() || saturating_add(top_f, top_b) >= mu) {
+            break;
+        }
+        if (forward.heap.size() <= backward.heap.size()) {
+            bidirectional_step(*state.graph_ptr, forward, backward, mu, meet);
+        } else {
+            bidirectional_step(state.reverse, backward, forward, mu, meet);
+        }
+        state.settled_count++;
+    }
+
+    vector<Id> path;
+    if (meet < 0) {
+        return {infinity_of<Weight>(), path};
+    }
+    for (Id v = meet; v != -1; v = forward.parent[v]) {
+        path.push_back(v);
+    }
+    reverse(path.begin(), path.end());
+    for (Id v = backward.parent[meet]; v != -1; v = backward.parent[v]) {
+        path.push_back(v);
+    }
+    return {mu, path};
+}
+
+/**
+ * Builds the transpose for one query, keep a Bidirectional_Dijkstra_State to answer many
+ */
+template<typename Weight, typename Id>
+pair<Weight, vector<Id>> bidirectional_dijkstra(const Basic_CSR_Graph<Weight, Id> &graph, Id s, Id t) {
+    Basic_Bidirectional_Dijkstra_State<Weight, Id> state(graph);
+    return bidirectional_dijkstra_query(state, s, t);
+}
+
+#endif //BIDIRECTIONAL_DIJKSTRA_HPP
@@ -4,27 +4,50 @@
 #include <queue> //#include <boost/heap/fibonacci_heap.hpp>
 #include <memory>
 #include <cassert>
+#include <atomic>
+#include <cstring>
+#include <cmath>
+#include <string>
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 #include "common.hpp"
+#include "csr_graph.hpp"
 #include "data_structures/BBL_DS.hpp"
+#include "data_structures/Pooled_BBL_DS.hpp"
+#include "data_structures/Indexed_DAry_Heap.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/op_counters.hpp"
 
 using namespace std;
 
-struct Path_T {
-    Dist_T length;
+/**
+ * Path label of BMSSP, ordered by (length, alpha, node). The bounds without a node, Basic_Path() included, have the
+ * largest node so they come after the paths of the same length.
+ * @tparam Dist weight and length type, the lengths of the shortest paths must stay below infinity_of<Dist>()
+ * @tparam Id vertex id type, signed since -1 is the missing parent
+ */
+template<typename Dist, typename Id = Node_id_T>
+struct Basic_Path {
+    using Length_T = Dist;
+    using Id_T = Id;
+
+    Dist length;
     int alpha; // number of nodes in the path
-    Node_id_T node;
-    Node_id_T parent;
+    Id node;
+    Id parent;
 
-    Path_T(): length(INF), alpha(0), node(INF), parent(-1) {}
-    Path_T(const Dist_T &ub): length(ub), alpha(0), node(INF), parent(-1) {}
-    Path_T(const Dist_T &ub, const Node_id_T &n): length(ub), alpha(0), node(n), parent(-1) {}
-    Path_T(const Dist_T &l, const int &a, const Node_id_T &n, const Node_id_T &p): length(l), alpha(a), node(n), parent(p) {}
+    Basic_Path(): length(infinity_of<Dist>()), alpha(0), node(numeric_limits<Id>::max()), parent(-1) {}
+    Basic_Path(const Dist &ub): length(ub), alpha(0), node(numeric_limits<Id>::max()), parent(-1) {}
+    Basic_Path(const Dist &ub, const Id &n): length(ub), alpha(0), node(n), parent(-1) {}
+    Basic_Path(const Dist &l, const int &a, const Id &n, const Id &p): length(l), alpha(a), node(n), parent(p) {}
 
-    constexpr bool operator==(const Path_T& other) const noexcept {
+    // bounds of the block lists, see Value_Bounds
+    static Basic_Path infinity() { return Basic_Path(); }
+    static Basic_Path lowest() { return Basic_Path(numeric_limits<Dist>::lowest()); }
+
+    constexpr bool operator==(const Basic_Path& other) const noexcept {
         return length == other.length && alpha == other.alpha && node == other.node;
     }
-    constexpr bool operator<(const Path_T& other) const noexcept {
+    constexpr bool operator<(const Basic_Path& other) const noexcept {
         if (length != other.length) {
             return length < other.length;
         }
@@ -33,12 +56,12 @@ struct Path_T {
         }
         return node < other.node;
     }
-    constexpr bool operator!=(const Path_T& other) const noexcept { return !(*this == other); }
-    constexpr bool operator>(const Path_T& other)  const noexcept { return other < *this; }
-    constexpr bool operator<=(const Path_T& other) const noexcept { return !(other < *this); }
-    constexpr bool operator>=(const Path_T& other) const noexcept { return !(*this < other); }
+    constexpr bool operator!=(const Basic_Path& other) const noexcept { return !(*this == other); }
+    constexpr bool operator>(const Basic_Path& other)  const noexcept { return other < *this; }
+    constexpr bool operator<=(const Basic_Path& other) const noexcept { return !(other < *this); }
+    constexpr bool operator>=(const Basic_Path& other) const noexcept { return !(*this < other); }
 
-    friend ostream& operator<<(ostream& os, const Path_T& p) {
+    friend ostream& operator<<(ostream& os, const Basic_Path& p) {
         os << "{length=" << p.length
            << ", node=" << p.node
            << ", parent=" << p.parent
@@ -48,158 +71,548 @@ struct Path_T {
     }
 };
 
-struct Edge {
-    Node_id_T to;
-    Dist_T w;
+using Path_T = Basic_Path<Dist_T>;
+
+/**
+ * Path lengths are never negative so their IEEE-754 bits, or the integer itself, compare like the lengths when read as
+ * unsigned integers, this is the key of the compare-and-swap min-updates of the parallel find_pivots
+ */
+template<typename Dist>
+inline uint64_t length_key(Dist length) noexcept {
+    typename conditional<sizeof(Dist) == sizeof(uint64_t), uint64_t, uint32_t>::type key;
+    static_assert(sizeof(key) == sizeof(Dist), "the lengths are 32 or 64 bits");
+    memcpy(&key, &length, sizeof(key));
+    return key;
+}
+
+/**
+ * Default layout of the path labels: one Path per vertex
+ */
+template<typename Dist, typename Id = Node_id_T>
+struct Basic_AoS_Paths {
+    using Length_T = Dist;
+    using Id_T = Id;
+    using Path = Basic_Path<Dist, Id>;
+
+    vector<Path> paths;
+
+    void assign(int n) {
+        paths.clear();
+        paths.reserve(n);
+        for (int i = 0; i < n; i++) {
+            paths.emplace_back(infinity_of<Dist>(), i);
+        }
+    }
+
+    const Path &get(Id v) const { return paths[v]; }
+    void set(Id v, const Path &p) { paths[v] = p; }
+    void reset(Id v) { paths[v] = Path(infinity_of<Dist>(), v); }
 
-    explicit Edge(Node_id_T to, Dist_T w) : to(to), w(w) {}
+    Dist length(Id v) const { return paths[v].length; }
+    int alpha(Id v) const { return paths[v].alpha; }
+    Id parent(Id v) const { return paths[v].parent; }
+
+    // p <= label of p.node
+    bool improved_by(const Path &p) const { return p <= paths[p.node]; }
+    // label of v < p
+    bool less_than(Id v, const Path &p) const { return paths[v] < p; }
 };
 
-struct BMSSP_State {
-    Graph *graph_ptr;
-    vector<vector<Edge>> adj;
-    vector<Path_T> paths;
-    vector<vector<Node_id_T>> forest;
-    unique_ptr<uint16_t[]> in_degree;
-    int cd_N;
-    unique_ptr<Node_id_T[]> subtree_func_visited_set;
-    int subtree_func_visited_token = 1;
-    unique_ptr<uint8_t[]> completed_stamp;
-    boost::dynamic_bitset<> W, Wi_1, Wi;
+/**
+ * Structure-of-arrays layout of the path labels: the relaxations mostly compare lengths so they only stream the
+ * lengths array, alpha is read on length ties and parent is only written.
+ */
+template<typename Dist, typename Id = Node_id_T>
+struct Basic_SoA_Paths {
+    using Length_T = Dist;
+    using Id_T = Id;
+    using Path = Basic_Path<Dist, Id>;
+
+    vector<Dist> lengths;
+    vector<int> alphas;
+    vector<Id> parents;
+
+    void assign(int n) {
+        lengths.assign(n, infinity_of<Dist>());
+        alphas.assign(n, 0);
+        parents.assign(n, -1);
+    }
 
-    explicit BMSSP_State(Graph &g, Node_id_T src) {
-        graph_ptr = &g;
-        auto weight_map = boost::get(boost::edge_weight, *graph_ptr);
-        cd_N = boost::num_vertices(*graph_ptr);
-        in_degree = make_unique<uint16_t[]>(cd_N); memset(in_degree.get(), 0, cd_N * sizeof(uint16_t));
-        forest.resize(cd_N);
-        subtree_func_visited_set = make_unique<Node_id_T[]>(cd_N); memset(subtree_func_visited_set.get(), -1, cd_N * sizeof(Node_id_T));
-        completed_stamp = make_unique<uint8_t[]>(cd_N); memset(completed_stamp.get(), UINT8_MAX, cd_N * sizeof(uint8_t));
-        W = boost::dynamic_bitset<>(cd_N);
-        Wi_1 = boost::dynamic_bitset<>(cd_N);
-        Wi = boost::dynamic_bitset<>(cd_N);
+    Path get(Id v) const { return {lengths[v], alphas[v], v, parents[v]}; }
 
-        paths.clear();
-        paths.reserve(cd_N);
-        adj.resize(cd_N);
-        for (int i = 0; i < cd_N; i++) {
-            paths.emplace_back(INF, i);
-            adj[i].reserve(boost::out_degree(i, g));
-            for (auto e=boost::out_edges(i, g); e.first != e.second; ++e.first) {
-                auto edg = *e.first;
-                adj[i].emplace_back(edg.m_target, weight_map[edg]);
-            }
+    void set(Id v, const Path &p) {
+        lengths[v] = p.length;
+        alphas[v] = p.alpha;
+        parents[v] = p.parent;
+    }
+
+    void reset(Id v) {
+        lengths[v] = infinity_of<Dist>();
+        alphas[v] = 0;
+        parents[v] = -1;
+    }
+
+    Dist length(Id v) const { return lengths[v]; }
+    int alpha(Id v) const { return alphas[v]; }
+    Id parent(Id v) const { return parents[v]; }
+
+    // same order as Basic_Path::operator<=, the nodes are equal
+    bool improved_by(const Path &p) const {
+        const Dist cur = lengths[p.node];
+        return p.length < cur || (p.length == cur && p.alpha <= alphas[p.node]);
+    }
+
+    bool less_than(Id v, const Path &p) const {
+        const Dist cur = lengths[v];
+        if (cur != p.length) {
+            return cur < p.length;
         }
-        paths[src].length = 0;
+        if (alphas[v] != p.alpha) {
+            return alphas[v] < p.alpha;
+        }
+        return v < p.node;
     }
 };
 
-inline Path_T temp_Path(const BMSSP_State &state, Node_id_T u, Node_id_T v, Dist_T w) noexcept {
-    return {state.paths[u].length + w, state.paths[u].alpha + 1, v, u};
-}
+using AoS_Paths = Basic_AoS_Paths<Dist_T>;
+using SoA_Paths = Basic_SoA_Paths<Dist_T>;
+
+/**
+ * Frontier of base_case_of_BMSSP as a binary heap with lazy deletion: an improved path is pushed again and the stale
+ * entries are skipped when popped
+ */
+template<typename Path = Path_T>
+struct Lazy_Path_Queue {
+    vector<Path> heap;
+    size_t peak = 0;
+
+    void assign(int) { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    void clear() { heap.clear(); }
+    size_t peak_size() const { return peak; }
+    void reset_peak() { peak = heap.size(); }
+
+    void push(const Path &p) {
+        heap.push_back(p);
+        push_heap(heap.begin(), heap.end(), greater<>());
+        peak = max(peak, heap.size());
+    }
 
-inline bool subtree_size_at_least_k(BMSSP_State &state, Node_id_T node, int k)
-{
-    if (k >= 2 && state.forest[node].size() < 1) {
-        return false;
+    Path pop() {
+        pop_heap(heap.begin(), heap.end(), greater<>());
+        Path p = heap.back();
+        heap.pop_back();
+        return p;
     }
+};
 
-    auto &visited = state.subtree_func_visited_set;
-    const int token = ++state.subtree_func_visited_token;
+/**
+ * Frontier of base_case_of_BMSSP as an indexed D-ary heap: a vertex is at most once in it, improvements decrease its key
+ */
+template<typename Path = Path_T, int D = 4>
+struct Indexed_Path_Queue {
+    Indexed_DAry_Heap<Path, D> heap;
+
+    void assign(int n) { heap.assign(n); }
+    bool empty() const { return heap.empty(); }
+    void clear() { heap.clear(); }
+    size_t peak_size() const { return heap.peak_size(); }
+    void reset_peak() { heap.reset_peak(); }
+
+    void push(const Path &p) {
+        heap.push_or_decrease(p.node, p);
+    }
 
-    vector<Node_id_T> stack;
-    stack.reserve(32);
+    Path pop() {
+        Path p = heap.top_key();
+        heap.pop();
+        return p;
+    }
+};
 
-    int count = 0;
-    stack.push_back(node);
+/**
+ * Forest of the parent links inside W built by find_pivots, in CSR form over the members of W: it is rebuilt by a
+ * counting sort on each call and its buffers only grow to the largest W seen.
+ * The vertices are addressed by their rank in members, which is sorted since W is read from a bitset.
+ */
+template<typename Id = Node_id_T>
+struct Basic_Pivot_Forest {
+    vector<Id> members;
+    vector<int> parent; // rank of the parent in members, -1 for a root
+    vector<int> child_offsets; // children of the rank i are children[child_offsets[i]..child_offsets[i+1])
+    vector<int> children;
+    vector<int> stack;
+
+    template<typename Paths>
+    void build(const boost::dynamic_bitset<> &W, const Paths &paths) {
+        members.clear();
+        for (auto v = W.find_first(); v != boost::dynamic_bitset<>::npos; v = W.find_next(v)) {
+            members.push_back(static_cast<Id>(v));
+        }
+        const int n = static_cast<int>(members.size());
+
+        parent.assign(n, -1);
+        child_offsets.assign(n+1, 0);
+        for (int i = 0; i < n; i++) {
+            const Id u = paths.parent(members[i]);
+            if (u >= 0 && W.test(u)) {
+                parent[i] = rank(u);
+                child_offsets[parent[i]+1]++;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            child_offsets[i+1] += child_offsets[i];
+        }
 
-    while (!stack.empty()) {
-        Node_id_T u = stack.back();
-        stack.pop_back();
+        children.resize(child_offsets[n]);
+        stack.assign(child_offsets.begin(), child_offsets.end()-1); // next free slot of each parent
+        for (int i = 0; i < n; i++) {
+            if (parent[i] >= 0) {
+                children[stack[parent[i]]++] = i;
+            }
+        }
+    }
 
-        if (visited[u] == token) {
-            continue;
+    // rank of the member v
+    int rank(Id v) const {
+        return static_cast<int>(lower_bound(members.begin(), members.end(), v) - members.begin());
+    }
+
+    bool is_root(int i) const {
+        return parent[i] < 0;
+    }
+
+    // the parent links only go to shorter paths so they can't loop, and a loop would still stop at k
+    bool subtree_size_at_least_k(int root, int k) {
+        if (k >= 2 && child_offsets[root+1] == child_offsets[root]) {
+            return false;
         }
+        stack.clear();
+        stack.push_back(root);
+        int count = 0;
+        while (!stack.empty()) {
+            const int i = stack.back();
+            stack.pop_back();
+            if (++count >= k) {
+                return true;
+            }
+            stack.insert(stack.end(), children.begin() + child_offsets[i], children.begin() + child_offsets[i+1]);
+        }
+        return false;
+    }
+};
 
-        visited[u] = token;
+using Pivot_Forest = Basic_Pivot_Forest<>;
+
+/**
+ * The k, t and l of BMSSP, 0 picks the paper's value for the graph, see resolved
+ */
+struct BMSSP_Params {
+    int k = 0; // pivot threshold and work per iteration, floor(log^(1/3) n) by default
+    int t = 0; // the block lists of level l hold 2^((l-1)t) pairs, floor(log^(2/3) n) by default
+    int l = 0; // recursion depth of the top call, at least ceil(log n / t) so it can complete every vertex
+    int hybrid_cutoff = 0; // the calls that may complete at most this many vertices run a Dijkstra instead, 0: never
+
+    BMSSP_Params() = default;
+    BMSSP_Params(int k, int t, int l = 0, int hybrid_cutoff = 0) : k(k), t(t), l(l), hybrid_cutoff(hybrid_cutoff) {}
+
+    /**
+     * The parameters used on a graph of n vertices, with the defaults filled in and l raised to its minimum
+     */
+    BMSSP_Params resolved(int n) const {
+        double log_n = log2(max(n, 1));
+        BMSSP_Params sortie;
+        sortie.k = k > 0 ? k : max(1, static_cast<int>(floor(pow(log_n, 1.0/3.0))));
+        sortie.t = t > 0 ? t : max(1, static_cast<int>(floor(pow(log_n, 2.0/3.0))));
+        sortie.l = max(l, static_cast<int>(ceil(log_n / static_cast<double>(sortie.t))));
+        sortie.hybrid_cutoff = hybrid_cutoff;
+        return sortie;
+    }
 
-        if (++count >= k) {
-            return true;
+    bool operator==(const BMSSP_Params &other) const {
+        return k == other.k && t == other.t && l == other.l && hybrid_cutoff == other.hybrid_cutoff;
+    }
+
+    string to_string() const {
+        string sortie = "k=" + std::to_string(k) + " t=" + std::to_string(t) + " l=" + std::to_string(l);
+        if (hybrid_cutoff > 0) {
+            sortie += " hybrid_cutoff=" + std::to_string(hybrid_cutoff);
+        }
+        return sortie;
+    }
+};
+
+/**
+ * Scratch memory of BMSSP bound to one graph. It is allocated once and can be reused for many sources,
+ * reset() only restores the vertices reached by the previous query.
+ * @tparam Paths layout of the path labels, Basic_AoS_Paths or Basic_SoA_Paths, its Length_T and Id_T are the weight and id
+ * types of the graph
+ * @tparam DS block-based linked list of the recursions, BBL_DS or Pooled_BBL_DS
+ * @tparam Queue frontier of the base case, Lazy_Path_Queue or Indexed_Path_Queue
+ */
+template<typename Paths, typename DS = BBL_DS<typename Paths::Id_T, typename Paths::Path>,
+         typename Queue = Lazy_Path_Queue<typename Paths::Path>>
+struct Basic_BMSSP_State {
+    using Length_T = typename Paths::Length_T;
+    using Id_T = typename Paths::Id_T;
+    using Path = typename Paths::Path;
+    using Graph_T = Basic_CSR_Graph<Length_T, Id_T>;
+
+    const Graph_T *graph_ptr;
+    Paths paths;
+    vector<Id_T> touched; // vertices whose path was set since the last reset
+    Basic_Pivot_Forest<Id_T> forest;
+    int cd_N;
+    unique_ptr<int[]> visited_set; // stamped with a fresh token by each bounded Dijkstra
+    int visited_token = 1;
+    unique_ptr<uint8_t[]> completed_stamp;
+    boost::dynamic_bitset<> W, Wi_1, Wi;
+
+    // parallel relaxation rounds of find_pivots, see enable_parallel_pivots
+    Thread_Pool *pool = nullptr;
+    size_t parallel_min_frontier = 0;
+    unique_ptr<atomic<uint64_t>[]> length_keys; // smallest length claimed per vertex during a round
+    vector<Id_T> frontier;
+    vector<vector<Path>> next_frontiers; // one buffer per worker, merged after each round
+    vector<unique_ptr<DS>> level_DS; // block lists kept between queries, see partial_order_DS
+    Queue base_case_queue; // peak_size() is the largest frontier of the base cases of the last query
+    BMSSP_Params params; // used by the next queries
+
+    explicit Basic_BMSSP_State(const Graph_T &g) {
+        graph_ptr = &g;
+        cd_N = graph_ptr->num_vertices();
+        visited_set = make_unique<int[]>(cd_N); memset(visited_set.get(), -1, cd_N * sizeof(int));
+        completed_stamp = make_unique<uint8_t[]>(cd_N); memset(completed_stamp.get(), UINT8_MAX, cd_N * sizeof(uint8_t));
+        W = boost::dynamic_bitset<>(cd_N);
+        Wi_1 = boost::dynamic_bitset<>(cd_N);
+        Wi = boost::dynamic_bitset<>(cd_N);
+
+        paths.assign(cd_N);
+        base_case_queue.assign(cd_N);
+    }
+
+    Basic_BMSSP_State(const Graph_T &g, Id_T src) : Basic_BMSSP_State(g) {
+        reset(src);
+    }
+
+    /**
+     * Relax the find_pivots rounds on the workers of pool when the frontier has at least min_frontier vertices
+     * @param pool must outlive the state and not be running anything else during the queries
+     */
+    void enable_parallel_pivots(Thread_Pool &thread_pool, size_t min_frontier = 4096) {
+        pool = &thread_pool;
+        parallel_min_frontier = min_frontier;
+        next_frontiers.assign(pool->size(), {});
+        length_keys = make_unique<atomic<uint64_t>[]>(cd_N);
+        for (int i = 0; i < cd_N; i++) {
+            length_keys[i].store(length_key(paths.length(i)), memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Block list of the recursion level l, the child recursions run at lower levels so they never share it. Its key map
+     * is sized to the graph once and reused by every call of the level.
+     */
+    DS &partial_order_DS(int l) {
+        if (l >= static_cast<int>(level_DS.size())) {
+            level_DS.resize(l+1);
+        }
+        if (!level_DS[l]) {
+            level_DS[l] = make_unique<DS>();
         }
+        return *level_DS[l];
+    }
 
-        const auto &children = state.forest[u];
-        for (const Node_id_T &v : children) {
-            if (visited[v] != token) {
-                stack.push_back(v);
+    void reset(Id_T src) {
+        for (const Id_T &v : touched) {
+            paths.reset(v);
+            completed_stamp[v] = UINT8_MAX;
+            if (length_keys) {
+                length_keys[v].store(length_key(infinity_of<Length_T>()), memory_order_relaxed);
             }
         }
+        touched.clear();
+        base_case_queue.clear();
+        base_case_queue.reset_peak();
+
+        // the visited token keeps growing between queries, only wrap it around
+        if (visited_token > INT32_MAX / 2) {
+            memset(visited_set.get(), -1, cd_N * sizeof(int));
+            visited_token = 1;
+        }
+
+        paths.set(src, Path(0, src));
+        touched.push_back(src);
     }
-    return false;
+};
+
+using BMSSP_State = Basic_BMSSP_State<AoS_Paths>;
+using SoA_BMSSP_State = Basic_BMSSP_State<SoA_Paths>;
+using Pooled_BMSSP_State = Basic_BMSSP_State<AoS_Paths, Pooled_BBL_DS<Node_id_T, Path_T>>;
+using Indexed_Heap_BMSSP_State = Basic_BMSSP_State<AoS_Paths, BBL_DS<Node_id_T, Path_T>, Indexed_Path_Queue<Path_T, 4>>;
+// half the bytes per label and per edge weight, on the graphs whose weights fit, see Basic_CSR_Graph::weights_fit
+using F32_BMSSP_State = Basic_BMSSP_State<Basic_AoS_Paths<float>>;
+using U32_BMSSP_State = Basic_BMSSP_State<Basic_AoS_Paths<uint32_t>>;
+
+template<typename State>
+inline typename State::Path temp_Path(const State &state, typename State::Id_T u, typename State::Id_T v,
+                                      typename State::Length_T w) noexcept {
+    return {saturating_add(state.paths.length(u), w), state.paths.alpha(u) + 1, v, u};
 }
 
-//TODO remake this from boost's dijkstra visitor?
-pair<Path_T, vector<Node_id_T>> base_case_of_BMSSP(BMSSP_State &state, int k, const Path_T &B, vector<Node_id_T> &S) {
-    assert(S.size() == 1);
+template<typename State>
+inline void set_path(State &state, typename State::Id_T v, const typename State::Path &p) {
+    if (state.paths.length(v) == infinity_of<typename State::Length_T>()) { // first time this query reaches v
+        state.touched.push_back(v);
+    }
+    state.paths.set(v, p);
+}
 
-    priority_queue<Path_T, vector<Path_T>, greater<>> min_heap;
-    min_heap.push(state.paths[S[0]]);
+/**
+ * Dijkstra from the complete vertices of S over the paths shorter than B, it settles at most limit+1 vertices.
+ * Same contract as BMSSP: (B, U) when at most limit vertices are found, else the path of the last one settled as B'
+ * and the limit vertices shorter than it as U.
+ */
+template<typename State>
+pair<typename State::Path, vector<typename State::Id_T>> bounded_dijkstra_of_BMSSP(State &state, int limit,
+                                                                                    const typename State::Path &B,
+                                                                                    const vector<typename State::Id_T> &S) {
+    using Path = typename State::Path;
+    using Id = typename State::Id_T;
+    auto &min_heap = state.base_case_queue;
+    min_heap.clear(); // the previous search may have stopped early
+    for (const Id &x : S) {
+        min_heap.push(state.paths.get(x));
+    }
 
-    vector<Node_id_T> U0;
+    vector<Id> U0;
+    // improved_by accepts equal paths, a vertex can be queued again after it was settled
+    auto &settled = state.visited_set;
+    const int token = ++state.visited_token;
 
-    while (!min_heap.empty() && static_cast<int>(U0.size()) < k+1) {
-        auto cur = min_heap.top();
-        min_heap.pop();
-        Node_id_T u = cur.node;
+    while (!min_heap.empty() && static_cast<int>(U0.size()) < limit+1) {
+        auto cur = min_heap.pop();
+        Id u = cur.node;
 
-        if (state.paths[u] > cur) {
+        if (state.paths.get(u) < cur || settled[u] == token) { // stale entry of a lazy queue
             continue;
         }
+        settled[u] = token;
         U0.push_back(u);
 
-        for (Edge &e: state.adj[u]) {
-            Path_T temp = temp_Path(state, u, e.to, e.w);
-            if (temp <= state.paths[e.to] && temp < B) {
-                state.paths[e.to] = temp;
+        for (const auto &e: state.graph_ptr->out_edges(u)) {
+            COUNT_OP(base_case_relaxations);
+            Path temp = temp_Path(state, u, e.to, e.w);
+            if (temp < B && state.paths.improved_by(temp)) {
+                set_path(state, e.to, temp);
                 min_heap.push(temp);
             }
         }
     }
 
-    if (static_cast<int>(U0.size()) <= k) {
+    if (static_cast<int>(U0.size()) <= limit) {
         return {B, U0};
     } else {
-        Path_T B_prime = state.paths[U0.back()]; //the max is the last one
-        U0.pop_back(); // we have k+1 and we want k elements
-        if (U0.size() > k) {
-            throw runtime_error("Check your base case logic it's not good");
-        }
+        Path B_prime = state.paths.get(U0.back()); //the max is the last one
+        U0.pop_back(); // we have limit+1 and we want limit elements
         return {B_prime, U0};
     }
 }
 
-pair<vector<Node_id_T>, boost::dynamic_bitset<>> find_pivots(BMSSP_State &state, int k, const Path_T &B, vector<Node_id_T> &S) {
-    for (auto u = state.W.find_first(); u != boost::dynamic_bitset<>::npos; u = state.W.find_next(u)) {
-        state.in_degree[u] = 0;
-        state.forest[u].clear();
+template<typename State>
+pair<typename State::Path, vector<typename State::Id_T>> base_case_of_BMSSP(State &state, int k,
+                                                                              const typename State::Path &B,
+                                                                              vector<typename State::Id_T> &S) {
+    assert(S.size() == 1);
+    COUNT_OP(base_case_calls);
+    return bounded_dijkstra_of_BMSSP(state, k, B, S);
+}
+
+inline bool claim_length(atomic<uint64_t> &slot, uint64_t key) noexcept {
+    uint64_t cur = slot.load(memory_order_relaxed);
+    while (key <= cur) {
+        if (key == cur || slot.compare_exchange_weak(cur, key, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * One relaxation round of find_pivots on the pool: the workers share the frontier Wi_1 and only read state.paths,
+ * the shortest candidate of each vertex is picked by a CAS min-update on its length key and kept in the worker's buffer.
+ * A path key (length, alpha, node) doesn't fit a 64 bits CAS so length ties go to the buffers and the serial merge
+ * settles them with the full comparison, then fills Wi like the serial loop.
+ */
+template<typename State>
+void parallel_relax_frontier(State &state, const typename State::Path &B) {
+    using Path = typename State::Path;
+    auto &frontier = state.frontier;
+    frontier.clear();
+    for (auto u = state.Wi_1.find_first(); u != boost::dynamic_bitset<>::npos; u = state.Wi_1.find_next(u)) {
+        frontier.push_back(u);
+        COUNT_OP_N(pivot_relaxations, state.graph_ptr->out_degree(u));
     }
+
+    const size_t chunk = 256;
+    atomic<size_t> next{0};
+    state.pool->run([&](int worker) {
+        auto &buffer = state.next_frontiers[worker];
+        buffer.clear();
+        for (size_t begin = next.fetch_add(chunk); begin < frontier.size(); begin = next.fetch_add(chunk)) {
+            size_t end = min(begin + chunk, frontier.size());
+            for (size_t i = begin; i < end; i++) {
+                auto u = frontier[i];
+                for (const auto &e: state.graph_ptr->out_edges(u)) {
+                    Path temp = temp_Path(state, u, e.to, e.w);
+                    if (state.paths.improved_by(temp) && claim_length(state.length_keys[e.to], length_key(temp.length))) {
+                        buffer.push_back(temp);
+                    }
+                }
+            }
+        }
+    });
+
+    for (const auto &buffer : state.next_frontiers) {
+        for (const Path &temp : buffer) {
+            if (state.paths.improved_by(temp)) {
+                set_path(state, temp.node, temp);
+                if (temp < B) {
+                    state.Wi.set(temp.node);
+                }
+            }
+        }
+    }
+}
+
+template<typename State>
+pair<vector<typename State::Id_T>, boost::dynamic_bitset<>> find_pivots(State &state, int k, const typename State::Path &B,
+                                                                        vector<typename State::Id_T> &S) {
+    using Id = typename State::Id_T;
+    COUNT_OP(find_pivots_calls);
     state.W.reset();
     state.Wi_1.reset();
-    vector<Node_id_T> P; P.reserve(S.size());
+    vector<Id> P; P.reserve(S.size());
 
-    for (const Node_id_T &u : S) {
+    for (const Id &u : S) {
         state.W.set(u);
         state.Wi_1.set(u);
     }
 
     for (int i = 1; i<= k; i++) {
         state.Wi.reset();
-        for (auto u = state.Wi_1.find_first(); u != boost::dynamic_bitset<>::npos; u = state.Wi_1.find_next(u)) {
-            for (const Edge &e: state.adj[u]) {
-                Path_T temp = temp_Path(state, u, e.to, e.w);
-                if (temp <= state.paths[e.to]) {
-                    state.paths[e.to] = temp;
-                    if (temp < B) {
-                        state.Wi.set(e.to);
+        if (state.pool != nullptr && state.Wi_1.count() >= state.parallel_min_frontier) {
+            parallel_relax_frontier(state, B);
+        } else {
+            for (auto u = state.Wi_1.find_first(); u != boost::dynamic_bitset<>::npos; u = state.Wi_1.find_next(u)) {
+                for (const auto &e: state.graph_ptr->out_edges(u)) {
+                    COUNT_OP(pivot_relaxations);
+                    auto temp = temp_Path(state, u, e.to, e.w);
+                    if (state.paths.improved_by(temp)) {
+                        set_path(state, e.to, temp);
+                        if (temp < B) {
+                            state.Wi.set(e.to);
+                        }
                     }
                 }
             }
@@ -211,63 +624,73 @@ pair<vector<Node_id_T>, boost::dynamic_bitset<>> find_pivots(BMSSP_State &state,
         state.Wi_1.swap(state.Wi);
     }
 
-    for (auto v = state.W.find_first(); v != boost::dynamic_bitset<>::npos; v = state.W.find_next(v)) {
-        const Node_id_T &u = state.paths[v].parent;
-        if (u >= 0 && state.W.test(u)) {
-            state.forest[u].push_back(v);
-            state.in_degree[v]++;
-        }
-    }
-
-    for (const Node_id_T &u : S) {
-        if (state.in_degree[u] == 0 && subtree_size_at_least_k(state, u, k)) {
+    state.forest.build(state.W, state.paths);
+    for (const Id &u : S) {
+        const int root = state.forest.rank(u);
+        if (state.forest.is_root(root) && state.forest.subtree_size_at_least_k(root, k)) {
             P.emplace_back(u);
         }
     }
+    COUNT_OP_N(pivots, P.size());
 
     return {P, state.W};
 }
 
-pair<Path_T, vector<Node_id_T>> BMSSP(BMSSP_State &state, int t, int k, int l, const Path_T &B, vector<Node_id_T> &S) {
-    assert(static_cast<int>(S.size()) <= static_cast<int>(pow(2, l*t)));
+template<typename State>
+pair<typename State::Path, vector<typename State::Id_T>> BMSSP(State &state, int t, int k, int l, const typename State::Path &B,
+                                                               vector<typename State::Id_T> &S) {
+    using Path = typename State::Path;
+    using Id = typename State::Id_T;
+    assert(S.size() <= pow(2, l*t));
+    COUNT_OP(bmssp_calls);
+    COUNT_OP_DEPTH();
 
     if (l == 0) {
         return base_case_of_BMSSP(state, k, B, S);
     }
 
+    // with a deeper l than needed the bounds pass N, cap them so they fit an int
+    int max_u_size = static_cast<int>(min(k * pow(2, l * t), static_cast<double>(INT32_MAX)));
+    if (max_u_size <= state.params.hybrid_cutoff) {
+        // a small subproblem costs less as a plain Dijkstra than with the pivots and the block lists
+        COUNT_OP(hybrid_calls);
+        return bounded_dijkstra_of_BMSSP(state, max_u_size, B, S);
+    }
+
     auto piv = find_pivots(state, k, B, S);
 
-    int M = static_cast<int>(pow(2, (l - 1) * t));
-    BBL_DS<Node_id_T, Path_T> D;
+    int M = static_cast<int>(min(pow(2, (l - 1) * t), static_cast<double>(state.cd_N)));
+    auto &D = state.partial_order_DS(l);
     D.initialize(M, B, state.cd_N);
-    Path_T B_prime = B;
+    Path B_prime = B;
     for (const auto &x : piv.first) {
-        D.insert_pair({x, state.paths[x]});
-        B_prime = min(B_prime, state.paths[x]);
+        const Path px = state.paths.get(x);
+        D.insert_pair({x, px});
+        B_prime = min(B_prime, px);
     }
 
-    int max_u_size = static_cast<int>(k * pow(2, l * t));
-    vector<Node_id_T> U; U.reserve(max_u_size);
+    vector<Id> U; U.reserve(min(max_u_size, state.cd_N));
 
     while (static_cast<int>(U.size()) < max_u_size && !D.empty()) {
-        Path_T Bi;
+        Path Bi;
         auto Si = D.pull(Bi);
 
-        Path_T prev_B_prime = B_prime;
+        Path prev_B_prime = B_prime;
         auto bmssp = BMSSP(state, t, k, l-1, Bi, Si);
         B_prime = bmssp.first;
         assert(prev_B_prime <= B_prime);
 
-        vector<pair<Node_id_T, Path_T>> K;
-        for (const Node_id_T &u : bmssp.second) {
+        vector<pair<Id, Path>> K;
+        for (const Id &u : bmssp.second) {
             U.push_back(u);
             state.completed_stamp[u] = l;
-            D.delete_pair({u, state.paths[u]});
+            D.delete_pair({u, state.paths.get(u)});
 
-            for (Edge &e: state.adj[u]) {
-                Path_T temp = temp_Path(state, u, e.to, e.w);
-                if (temp <= state.paths[e.to]) {
-                    state.paths[e.to] = temp;
+            for (const auto &e: state.graph_ptr->out_edges(u)) {
+                COUNT_OP(bmssp_relaxations);
+                Path temp = temp_Path(state, u, e.to, e.w);
+                if (state.paths.improved_by(temp)) {
+                    set_path(state, e.to, temp);
                     if (Bi <= temp && temp < B) {
                         D.insert_pair({e.to, temp});
                     } else if (B_prime <= temp && temp < Bi) {
@@ -276,9 +699,10 @@ pair<Path_T, vector<Node_id_T>> BMSSP(BMSSP_State &state, int t, int k, int l, c
                 }
             }
         }
-        for (const Node_id_T &x : Si) {
-            if (B_prime <= state.paths[x] && state.paths[x] < Bi) {
-                K.push_back({x, state.paths[x]});
+        for (const Id &x : Si) {
+            const Path px = state.paths.get(x);
+            if (B_prime <= px && px < Bi) {
+                K.push_back({x, px});
             }
         }
         D.batch_prepend(K);
@@ -286,7 +710,7 @@ pair<Path_T, vector<Node_id_T>> BMSSP(BMSSP_State &state, int t, int k, int l, c
 
     B_prime = min(B_prime, B);
     for (auto x = piv.second.find_first(); x != boost::dynamic_bitset<>::npos; x = piv.second.find_next(x)) {
-        if (state.paths[x] < B_prime && state.completed_stamp[x] != l) {
+        if (state.paths.less_than(x, B_prime) && state.completed_stamp[x] != l) {
             U.push_back(x);
         }
     }
@@ -294,26 +718,86 @@ pair<Path_T, vector<Node_id_T>> BMSSP(BMSSP_State &state, int t, int k, int l, c
     return {B_prime, U};
 }
 
-pair<Dist_List_T, Prev_List_T> top_level_BMSSP(Graph& g, Node_id_T src, int N) {
-    BMSSP_State state(g, src);
-    Path_T B{};
-    double log_n = log2(state.cd_N);
-    int k = static_cast<int>(floor(pow(log_n, 1.0/3.0))); // work per iteration
-    int t = static_cast<int>(floor(pow(log_n, 2.0/3.0)));
-
-    int l = static_cast<int>(ceil(log_n / static_cast<double>(t))); //number of recursions
-    vector<Node_id_T> S = {src};
-
-    auto res = BMSSP(state, t, k, l, B, S);
+/**
+ * Top level call of BMSSP from src: the vertices closer than B get their final path in state.paths
+ * @param B Path{} for the whole graph, the search only explores the paths shorter than B
+ */
+template<typename State>
+void bounded_BMSSP_search(State &state, typename State::Id_T src, const typename State::Path &B) {
+    state.reset(src);
+    const BMSSP_Params params = state.params.resolved(state.cd_N);
+    vector<typename State::Id_T> S = {src};
+
+    BMSSP(state, params.t, params.k, params.l, B, S);
+}
 
-    Dist_List_T dist; dist.reserve(N);
-    Prev_List_T parent; parent.reserve(N);
-    for (int x = 0; x < N; x++) {
-        dist.emplace_back(state.paths[x].length);
-        parent.emplace_back(state.paths[x].parent);
+/**
+ * Runs BMSSP from src reusing the scratch memory of state, use it when many sources share the same graph
+ * @param state workspace bound to the graph, it is reset for src
+ * @return distances, in the graph's weight type, and parents of the N first vertices
+ */
+template<typename State>
+pair<vector<typename State::Length_T>, vector<typename State::Id_T>> BMSSP_query(State &state, typename State::Id_T src,
+                                                                                 int N) {
+    using Id = typename State::Id_T;
+    bounded_BMSSP_search(state, src, typename State::Path{});
+
+    vector<typename State::Length_T> dist; dist.reserve(N);
+    vector<Id> parent; parent.reserve(N);
+    for (Id x = 0; x < N; x++) {
+        dist.emplace_back(state.paths.length(x));
+        parent.emplace_back(state.paths.parent(x));
     }
 
     return {dist, parent};
 }
 
+pair<Dist_List_T, Prev_List_T> top_level_BMSSP(const CSR_Graph& g, Node_id_T src, int N) {
+    BMSSP_State state(g);
+    return BMSSP_query(state, src, N);
+}
+
+/**
+ * top_level_BMSSP with the given k, t and l instead of the paper's
+ */
+pair<Dist_List_T, Prev_List_T> top_level_BMSSP_with_params(const CSR_Graph& g, Node_id_T src, int N, const BMSSP_Params &params) {
+    BMSSP_State state(g);
+    state.params = params;
+    return BMSSP_query(state, src, N);
+}
+
+/**
+ * top_level_BMSSP with the path labels stored as structure of arrays
+ */
+pair<Dist_List_T, Prev_List_T> soa_top_level_BMSSP(const CSR_Graph& g, Node_id_T src, int N) {
+    SoA_BMSSP_State state(g);
+    return BMSSP_query(state, src, N);
+}
+
+/**
+ * top_level_BMSSP with the blocks of the recursions kept in pools
+ */
+pair<Dist_List_T, Prev_List_T> pooled_top_level_BMSSP(const CSR_Graph& g, Node_id_T src, int N) {
+    Pooled_BMSSP_State state(g);
+    return BMSSP_query(state, src, N);
+}
+
+/**
+ * top_level_BMSSP with an indexed 4-ary heap in the base case
+ */
+pair<Dist_List_T, Prev_List_T> indexed_heap_top_level_BMSSP(const CSR_Graph& g, Node_id_T src, int N) {
+    Indexed_Heap_BMSSP_State state(g);
+    return BMSSP_query(state, src, N);
+}
+
+/**
+ * top_level_BMSSP with the relaxation rounds of find_pivots running on threads workers
+ */
+pair<Dist_List_T, Prev_List_T> parallel_top_level_BMSSP(const CSR_Graph& g, Node_id_T src, int N, int threads, size_t min_frontier = 4096) {
+    Thread_Pool pool(threads);
+    BMSSP_State state(g);
+    state.enable_parallel_pivots(pool, min_frontier);
+    return BMSSP_query(state, src, N);
+}
+
 #endif //BMSSP_HPP
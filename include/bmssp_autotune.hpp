@@ -0,0 +1,185 @@
+#ifndef BMSSP_AUTOTUNE_HPP
+#define BMSSP_AUTOTUNE_HPP
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "bmssp.hpp"
+
+/*
+ * The paper's k and t are asymptotic choices. autotune_BMSSP times a sweep of (k, t, l) and hybrid cutoffs around them
+ * on a sample of sources and keeps the fastest, the result is saved per graph fingerprint so a graph is only tuned once.
+ * The parameters file has one "fingerprint k t l hybrid_cutoff ms_per_query" line per graph, the fingerprint in
+ * hexadecimal.
+ */
+
+using namespace std;
+
+/**
+ * FNV-1a hash of the vertex count and of the CSR arrays, equal graphs have the same fingerprint
+ */
+inline uint64_t graph_fingerprint(const CSR_Graph &g) {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void *data, size_t bytes) {
+        const auto *p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            h = (h ^ p[i]) * 1099511628211ull;
+        }
+    };
+    const int64_t N = g.num_vertices();
+    mix(&N, sizeof(N));
+    mix(g.offsets_data(), (N+1) * sizeof(CSR_Graph::Edge_id_T));
+    mix(g.targets_data(), g.num_edges() * sizeof(Node_id_T));
+    mix(g.weights_data(), g.num_edges() * sizeof(Dist_T));
+    return h;
+}
+
+struct BMSSP_Tuning {
+    BMSSP_Params params; // resolved for the tuned graph
+    double ms_per_query = 0;
+};
+
+/**
+ * The sweep of autotune_BMSSP: k up to 2 past the paper's value, t within 2 of it, the minimal l and one more level,
+ * each without the hybrid mode and with Dijkstra on the calls of level 1 and 2
+ */
+inline vector<BMSSP_Params> BMSSP_param_candidates(int n) {
+    const BMSSP_Params paper = BMSSP_Params().resolved(n);
+    vector<BMSSP_Params> sortie;
+    for (int k = 1; k <= paper.k + 2; k++) {
+        for (int t = max(1, paper.t - 2); t <= paper.t + 2; t++) {
+            const BMSSP_Params shallow = BMSSP_Params(k, t).resolved(n);
+            for (int level = 0; level <= 2; level++) {
+                // the calls of level l may complete k 2^(lt) vertices
+                const int cutoff = level == 0 ? 0 : static_cast<int>(min(k * pow(2, level * t), static_cast<double>(n)));
+                sortie.push_back(BMSSP_Params(k, t, shallow.l, cutoff));
+                sortie.push_back(BMSSP_Params(k, t, shallow.l + 1, cutoff));
+            }
+        }
+    }
+    return sortie;
+}
+
+/**
+ * Times every candidate on the same sample of sources and returns the fastest, the candidates whose distances differ
+ * from the paper's parameters are skipped
+ * @param sources_count sample size, the sources are drawn among the vertices with out-edges
+ * @param candidates BMSSP_param_candidates(n) when empty
+ */
+template<typename State = BMSSP_State>
+BMSSP_Tuning autotune_BMSSP(const CSR_Graph &g, int sources_count = 8, unsigned seed = 1234,
+                            vector<BMSSP_Params> candidates = {}) {
+    const int N = g.num_vertices();
+    if (candidates.empty()) {
+        candidates = BMSSP_param_candidates(N);
+    }
+
+    mt19937 rng(seed);
+    uniform_int_distribution<Node_id_T> pick(0, max(N-1, 0));
+    vector<Node_id_T> sources;
+    for (int tries = 0; static_cast<int>(sources.size()) < sources_count && tries < 100 * sources_count; tries++) {
+        Node_id_T s = pick(rng);
+        if (g.out_degree(s) > 0) {
+            sources.push_back(s);
+        }
+    }
+    if (sources.empty()) {
+        sources.push_back(0);
+    }
+
+    State state(g);
+    vector<Dist_List_T> expected;
+    for (const Node_id_T &s : sources) {
+        expected.push_back(BMSSP_query(state, s, N).first);
+    }
+
+    BMSSP_Tuning best;
+    best.params = BMSSP_Params().resolved(N);
+    best.ms_per_query = INF;
+    for (const BMSSP_Params &candidate : candidates) {
+        state.params = candidate;
+        bool same = true;
+        auto t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < sources.size() && same; i++) {
+            same = BMSSP_query(state, sources[i], N).first == expected[i];
+        }
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - t0;
+
+        const double ms = elapsed.count() / sources.size();
+        if (same && ms < best.ms_per_query) {
+            best.params = candidate.resolved(N);
+            best.ms_per_query = ms;
+        }
+    }
+    return best;
+}
+
+/**
+ * Reads the parameters saved for fingerprint
+ * @return false when the file or the fingerprint's line is missing
+ */
+inline bool load_BMSSP_params(const string &filename, uint64_t fingerprint, BMSSP_Tuning &tuning) {
+    ifstream file(filename);
+    string line;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        uint64_t key;
+        BMSSP_Tuning read;
+        if (fields >> hex >> key >> dec >> read.params.k >> read.params.t >> read.params.l >> read.params.hybrid_cutoff
+            >> read.ms_per_query && key == fingerprint) {
+            tuning = read;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Writes the parameters of fingerprint to the file, replacing its previous line and keeping the other graphs'
+ */
+inline void save_BMSSP_params(const string &filename, uint64_t fingerprint, const BMSSP_Tuning &tuning) {
+    vector<string> lines;
+    {
+        ifstream file(filename);
+        string line;
+        while (getline(file, line)) {
+            istringstream fields(line);
+            uint64_t key;
+            if (!(fields >> hex >> key) || key != fingerprint) {
+                lines.push_back(line);
+            }
+        }
+    }
+
+    ostringstream entry;
+    entry << hex << fingerprint << dec << " " << tuning.params.k << " " << tuning.params.t << " " << tuning.params.l
+          << " " << tuning.params.hybrid_cutoff << " " << tuning.ms_per_query;
+    lines.push_back(entry.str());
+
+    ofstream file(filename, ios::trunc);
+    if (!file) {
+        throw runtime_error("Cannot write the BMSSP parameters to " + filename);
+    }
+    for (const string &line : lines) {
+        file << line << "\n";
+    }
+}
+
+/**
+ * The parameters saved for g in filename, g is tuned and its result saved when they are missing
+ */
+template<typename State = BMSSP_State>
+BMSSP_Tuning tuned_BMSSP_params(const CSR_Graph &g, const string &filename, int sources_count = 8) {
+    const uint64_t fingerprint = graph_fingerprint(g);
+    BMSSP_Tuning tuning;
+    if (!load_BMSSP_params(filename, fingerprint, tuning)) {
+        tuning = autotune_BMSSP<State>(g, sources_count);
+        save_BMSSP_params(filename, fingerprint, tuning);
+    }
+    return tuning;
+}
+
+#endif //BMSSP_AUTOTUNE_HPP
@@ -0,0 +1,278 @@
+#ifndef BOUNDED_SSSP_HPP
+#define BOUNDED_SSSP_HPP
+
+#include <cmath>
+#include <type_traits>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "dijkstras.hpp"
+#include "bmssp.hpp"
+
+/*
+ * Point-to-point and radius queries: the search stops once every target is settled or once the next vertex is farther
+ * than the radius. The states are reset through the vertices reached by the previous query and the result only lists
+ * the settled vertices, so a query costs time in the explored region instead of in N.
+ */
+
+using namespace std;
+
+struct Bounded_Query {
+    vector<Node_id_T> targets; // the search stops once they are all settled, none for a radius only query
+    Dist_T radius = INF; // the vertices farther than this are not settled
+};
+
+/**
+ * The settled vertices with their distance, in the graph's weight type, and parent, the unreached targets are missing
+ */
+template<typename Dist, typename Id = Node_id_T>
+struct Basic_Bounded_Result {
+    vector<Id> nodes;
+    vector<Dist> dist;
+    vector<Id> parent;
+
+    void add(Id v, Dist d, Id p) {
+        nodes.push_back(v);
+        dist.push_back(d);
+        parent.push_back(p);
+    }
+};
+
+using Bounded_Result = Basic_Bounded_Result<Dist_T>;
+
+/**
+ * Targets of the current query, marked with a stamp so starting a query doesn't touch the other vertices
+ */
+struct Target_Marks {
+    vector<uint32_t> stamp;
+    uint32_t current = 0;
+    size_t remaining = 0;
+
+    explicit Target_Marks(int n) : stamp(n, 0) {}
+
+    void start(const vector<Node_id_T> &targets) {
+        if (++current == 0) {
+            fill(stamp.begin(), stamp.end(), 0);
+            current = 1;
+        }
+        remaining = 0;
+        for (const Node_id_T &t : targets) {
+            if (stamp[t] != current) {
+                stamp[t] = current;
+                remaining++;
+            }
+        }
+    }
+
+    // true once v was the last target left
+    bool settle(Node_id_T v) {
+        if (stamp[v] == current) {
+            stamp[v] = 0;
+            return --remaining == 0;
+        }
+        return false;
+    }
+
+    bool any() const {
+        return remaining > 0;
+    }
+};
+
+/**
+ * Scratch memory of the bounded binary heap Dijkstra bound to one graph
+ */
+template<typename Weight, typename Id = Node_id_T>
+struct Basic_Bounded_Dijkstra_State {
+    using Graph_T = Basic_CSR_Graph<Weight, Id>;
+    const Graph_T *graph_ptr;
+    vector<Weight> dist;
+    vector<Id> parent;
+    vector<Id> touched; // vertices whose distance was set since the last reset
+    vector<Basic_Node<Weight, Id>> heap;
+    Target_Marks targets;
+
+    explicit Basic_Bounded_Dijkstra_State(const Graph_T &g) :
+        graph_ptr(&g), dist(g.num_vertices(), infinity_of<Weight>()), parent(g.num_vertices(), -1),
+        targets(g.num_vertices()) {}
+
+    void reset() {
+        for (const Id &v : touched) {
+            dist[v] = infinity_of<Weight>();
+            parent[v] = -1;
+        }
+        touched.clear();
+        heap.clear();
+    }
+};
+
+using Bounded_Dijkstra_State = Basic_Bounded_Dijkstra_State<Dist_T>;
+
+/**
+ * Dijkstra from src until the targets of query are settled or the radius is passed
+ */
+template<typename Weight, typename Id>
+Basic_Bounded_Result<Weight, Id> bounded_dijkstra_query(Basic_Bounded_Dijkstra_State<Weight, Id> &state, Id src,
+                                                        const Bounded_Query &query) {
+    using Node = Basic_Node<Weight, Id>;
+    state.reset();
+    state.targets.start(query.targets);
+    const bool has_targets = state.targets.any();
+    auto &dist = state.dist;
+    auto &parent = state.parent;
+    auto &heap = state.heap;
+    Basic_Bounded_Result<Weight, Id> result;
+
+    dist[src] = 0;
+    state.touched.push_back(src);
+    heap.push_back(Node{src, 0});
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end());
+        Node cur = heap.back();
+        heap.pop_back();
+        if (cur.distance > dist[cur.name]) { // stale entry
+            continue;
+        }
+        if (cur.distance > query.radius) {
+            break;
+        }
+        result.add(cur.name, cur.distance, parent[cur.name]);
+        if (has_targets && state.targets.settle(cur.name)) {
+            break;
+        }
+
+        for (const auto &e : state.graph_ptr->out_edges(cur.name)) {
+            Weight temp = saturating_add(cur.distance, e.w);
+            if (temp < dist[e.to]) {
+                if (dist[e.to] == infinity_of<Weight>()) {
+                    state.touched.push_back(e.to);
+                }
+                dist[e.to] = temp;
+                parent[e.to] = cur.name;
+                heap.push_back(Node{e.to, temp});
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Scratch memory of the bounded Boost Dijkstra, Boost runs on the maps kept here without initializing them
+ */
+struct Bounded_Boost_State {
+    Graph *graph_ptr;
+    Dist_List_T dist;
+    Prev_List_T parent;
+    vector<boost::default_color_type> colors;
+    vector<Node_id_T> touched;
+    Target_Marks targets;
+
+    explicit Bounded_Boost_State(Graph &g) :
+        graph_ptr(&g), dist(boost::num_vertices(g), INF), parent(boost::num_vertices(g), -1),
+        colors(boost::num_vertices(g), boost::white_color), targets(boost::num_vertices(g)) {}
+
+    void reset() {
+        for (const Node_id_T &v : touched) {
+            dist[v] = INF;
+            parent[v] = -1;
+            colors[v] = boost::white_color;
+        }
+        touched.clear();
+    }
+};
+
+/**
+ * Records the settled vertices and stops Boost by throwing once the query is answered, the way Boost suggests
+ */
+struct Bounded_Boost_Visitor : public boost::default_dijkstra_visitor {
+    struct Stop {};
+
+    Bounded_Boost_State *state;
+    const Bounded_Query *query;
+    Bounded_Result *result;
+    bool has_targets;
+
+    void discover_vertex(Node_id_T v, const Graph &) const {
+        state->touched.push_back(v);
+    }
+
+    void examine_vertex(Node_id_T u, const Graph &) const {
+        if (state->dist[u] > query->radius) {
+            throw Stop{};
+        }
+        result->add(u, state->dist[u], state->parent[u]);
+        if (has_targets && state->targets.settle(u)) {
+            throw Stop{};
+        }
+    }
+};
+
+Bounded_Result bounded_boost_dijkstra(Bounded_Boost_State &state, Node_id_T src, const Bounded_Query &query) {
+    state.reset();
+    state.targets.start(query.targets);
+    Bounded_Result result;
+    Graph &g = *state.graph_ptr;
+    auto index = boost::get(boost::vertex_index, g);
+
+    state.dist[src] = 0;
+    state.parent[src] = -1;
+    Bounded_Boost_Visitor visitor;
+    visitor.state = &state;
+    visitor.query = &query;
+    visitor.result = &result;
+    visitor.has_targets = state.targets.any();
+    try {
+        boost::dijkstra_shortest_paths_no_init(g, src,
+            boost::make_iterator_property_map(state.parent.begin(), index),
+            boost::make_iterator_property_map(state.dist.begin(), index),
+            boost::get(boost::edge_weight, g), index, less<Dist_T>(), boost::closed_plus<Dist_T>(INF), Dist_T(0),
+            visitor, boost::make_iterator_property_map(state.colors.begin(), index));
+    } catch (const Bounded_Boost_Visitor::Stop &) {}
+
+    return result;
+}
+
+/**
+ * Smallest floating point Length_T above radius: the paths shorter than it are the paths within the radius
+ */
+template<typename Length_T>
+Length_T length_above(Dist_T radius, false_type) {
+    Length_T sortie = static_cast<Length_T>(radius);
+    return sortie > radius ? sortie : nextafter(sortie, infinity_of<Length_T>());
+}
+
+/**
+ * Same for an integer Length_T, the integer lengths within the radius are the ones up to floor(radius)
+ */
+template<typename Length_T>
+Length_T length_above(Dist_T radius, true_type) {
+    return static_cast<Length_T>(floor(max(radius, Dist_T(0))) + 1);
+}
+
+/**
+ * BMSSP with the radius as initial bound B instead of Path{}, it only explores the paths within the radius.
+ * BMSSP has no settling order to stop at a target: the targets don't bound the search, give a radius for that.
+ * The result lists the vertices within the radius, not sorted by distance.
+ */
+template<typename State>
+Basic_Bounded_Result<typename State::Length_T, typename State::Id_T> bounded_BMSSP_query(State &state,
+                                                                                       typename State::Id_T src,
+                                                                                       const Bounded_Query &query) {
+    using Length_T = typename State::Length_T;
+    typename State::Path B{};
+    if (query.radius < numeric_limits<Length_T>::max()) {
+        B = typename State::Path(length_above<Length_T>(query.radius, is_integral<Length_T>()));
+    }
+    bounded_BMSSP_search(state, src, B);
+
+    Basic_Bounded_Result<Length_T, typename State::Id_T> result;
+    for (const auto &v : state.touched) {
+        if (state.paths.length(v) <= query.radius) {
+            result.add(v, state.paths.length(v), state.paths.parent(v));
+        }
+    }
+    return result;
+}
+
+#endif //BOUNDED_SSSP_HPP
@@ -1,15 +1,36 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
+#include <limits>
 #include <boost/graph/adjacency_list.hpp>
 
-#define INF 10000000 // DBL_MAX
+/**
+ * Distance of the unreached vertices: infinity for the floating point types, the largest value for the integer ones
+ */
+template<typename T>
+constexpr T infinity_of() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+/**
+ * length + w of non negative values, capped at infinity_of<T>() for the integer types instead of wrapping around
+ */
+template<typename T>
+inline T saturating_add(T length, T w) noexcept {
+    if (!std::numeric_limits<T>::has_infinity && length > infinity_of<T>() - w) {
+        return infinity_of<T>();
+    }
+    return length + w;
+}
+
 using Dist_T = double;
-using Node_id_T = int;
+using Node_id_T = int; // the engines mark a missing parent with -1, the id types are signed
+constexpr Dist_T INF = infinity_of<Dist_T>();
 using VertexProp = boost::property<boost::vertex_name_t, Node_id_T>;
 using EdgeProp = boost::property<boost::edge_weight_t, Dist_T>;
 using Dist_List_T = std::vector<Dist_T>;
 using Prev_List_T = std::vector<Node_id_T>;
-using Graph = boost::adjacency_list <boost::vecS, boost::vecS, boost::directedS, VertexProp, EdgeProp>; //TODO try CSR graphs
+using SSSP_Result = std::pair<Dist_List_T, Prev_List_T>;
+using Graph = boost::adjacency_list <boost::vecS, boost::vecS, boost::directedS, VertexProp, EdgeProp>; // the SSSP engines use CSR_Graph from csr_graph.hpp
 
 #endif //COMMON_HPP
@@ -0,0 +1,354 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include "common.hpp"
+
+/*
+ * Compressed sparse row graph: the out-edges of u are targets[offsets[u]..offsets[u+1]) with the matching weights.
+ * The SSSP engines traverse this instead of the Boost adjacency_list.
+ * The arrays are either owned or a view over external memory such as a memory mapped snapshot, see FileUtils.
+ * Basic_CSR_Graph is templated on the weight and id types, CSR_Graph keeps the double weights of the Boost graphs and
+ * F32_CSR_Graph / U32_CSR_Graph halve the weight array when the weights fit, see weights_fit.
+ */
+
+using namespace std;
+
+template<typename Weight, typename Id = Node_id_T>
+struct Basic_Edge {
+    Id to;
+    Weight w;
+
+    explicit Basic_Edge(Id to, Weight w) : to(to), w(w) {}
+};
+
+using Edge = Basic_Edge<Dist_T>;
+
+/**
+ * Edges kept in insertion order, the generators fill this so the same output can become a Graph or a CSR_Graph
+ */
+struct Edge_List {
+    int64_t nodes_count = 0;
+    vector<Node_id_T> sources;
+    vector<Node_id_T> targets;
+    vector<Dist_T> weights;
+
+    Edge_List() = default;
+
+    explicit Edge_List(int64_t n): nodes_count(n) {}
+
+    void reserve(int64_t m) {
+        sources.reserve(m);
+        targets.reserve(m);
+        weights.reserve(m);
+    }
+
+    // like boost::add_edge, the vertex count grows to fit the endpoints
+    void add_edge(Node_id_T u, Node_id_T v, Dist_T w) {
+        sources.push_back(u);
+        targets.push_back(v);
+        weights.push_back(w);
+        nodes_count = max(nodes_count, static_cast<int64_t>(max(u, v)) + 1);
+    }
+
+    int64_t size() const {
+        return static_cast<int64_t>(sources.size());
+    }
+
+    Graph to_graph() const {
+        Graph G(nodes_count);
+        for (int64_t i = 0; i < size(); i++) {
+            boost::add_edge(sources[i], targets[i], weights[i], G);
+        }
+        return G;
+    }
+};
+
+template<typename Weight = Dist_T, typename Id = Node_id_T>
+class Basic_CSR_Graph {
+public:
+    using Edge_id_T = int64_t;
+    using Weight_T = Weight;
+    using Id_T = Id;
+    using Edge_T = Basic_Edge<Weight, Id>;
+
+    class Out_Edges {
+    public:
+        struct iterator {
+            const Id *to;
+            const Weight *w;
+
+            Edge_T operator*() const { return Edge_T(*to, *w); }
+            iterator &operator++() { ++to; ++w; return *this; }
+            bool operator!=(const iterator &other) const { return to != other.to; }
+            bool operator==(const iterator &other) const { return to == other.to; }
+        };
+
+        Out_Edges(const Id *to, const Weight *w, size_t n): to(to), w(w), n(n) {}
+
+        iterator begin() const { return {to, w}; }
+        iterator end() const { return {to + n, w + n}; }
+        size_t size() const { return n; }
+        bool empty() const { return n == 0; }
+
+    private:
+        const Id *to;
+        const Weight *w;
+        size_t n;
+    };
+
+    Basic_CSR_Graph() {
+        auto arrays = make_shared<Owned_Arrays>();
+        arrays->offsets.assign(1, 0);
+        adopt(arrays);
+    }
+
+    /**
+     * Counting sort of the edges by source, each vertex keeps its edges in insertion order
+     */
+    explicit Basic_CSR_Graph(const Edge_List &edges) {
+        build(&edges, 1, edges.nodes_count, false);
+    }
+
+    /**
+     * Same as above for edges split in chunks, taken in chunk order
+     * @param nodes_count grows to fit the chunks
+     * @param both_directions also add v->u right after every u->v, for undirected inputs
+     */
+    Basic_CSR_Graph(const vector<Edge_List> &chunks, int64_t nodes_count, bool both_directions) {
+        build(chunks.data(), chunks.size(), nodes_count, both_directions);
+    }
+
+    /**
+     * Takes over arrays already in CSR layout
+     * @param offsets one entry per vertex plus the final edge count
+     */
+    Basic_CSR_Graph(vector<Edge_id_T> offsets, vector<Id> targets, vector<Weight> weights) {
+        auto arrays = make_shared<Owned_Arrays>();
+        arrays->offsets = move(offsets);
+        arrays->targets = move(targets);
+        arrays->weights = move(weights);
+        adopt(arrays);
+    }
+
+    explicit Basic_CSR_Graph(const Graph &g) {
+        const int64_t N = boost::num_vertices(g);
+        auto weight_map = boost::get(boost::edge_weight, g);
+        auto arrays = make_shared<Owned_Arrays>();
+        arrays->offsets.reserve(N+1);
+        arrays->targets.reserve(boost::num_edges(g));
+        arrays->weights.reserve(boost::num_edges(g));
+
+        arrays->offsets.push_back(0);
+        for (int64_t u = 0; u < N; u++) {
+            for (auto e = boost::out_edges(u, g); e.first != e.second; ++e.first) {
+                arrays->targets.push_back(boost::target(*e.first, g));
+                arrays->weights.push_back(static_cast<Weight>(weight_map[*e.first]));
+            }
+            arrays->offsets.push_back(static_cast<Edge_id_T>(arrays->targets.size()));
+        }
+        adopt(arrays);
+    }
+
+    /**
+     * Zero-copy read-only view over arrays kept alive by holder (e.g. a memory mapped file), nothing is scanned
+     * @param offsets nodes_count+1 entries
+     * @param integer_weights, max_weight the weight summary, see has_integer_weights
+     */
+    Basic_CSR_Graph(shared_ptr<const void> holder, int64_t nodes_count, int64_t edges_count,
+                    const Edge_id_T *offsets, const Id *targets, const Weight *weights,
+                    bool integer_weights, Weight max_weight):
+        holder(move(holder)), nodes_count(nodes_count), edges_count(edges_count),
+        offsets(offsets), targets(targets), weights(weights),
+        integer_weights(integer_weights), max_weight_value(max_weight) {}
+
+    /**
+     * Copy of other with its weights and ids cast to Weight and Id, check weights_fit first for an exact copy
+     */
+    template<typename Other_Weight, typename Other_Id>
+    explicit Basic_CSR_Graph(const Basic_CSR_Graph<Other_Weight, Other_Id> &other) {
+        const int64_t N = other.num_vertices();
+        const int64_t M = other.num_edges();
+        auto arrays = make_shared<Owned_Arrays>();
+        arrays->offsets.assign(other.offsets_data(), other.offsets_data() + N + 1);
+        arrays->targets.resize(M);
+        arrays->weights.resize(M);
+        for (int64_t e = 0; e < M; e++) {
+            arrays->targets[e] = static_cast<Id>(other.target(e));
+            arrays->weights[e] = static_cast<Weight>(other.weight(e));
+        }
+        adopt(arrays);
+    }
+
+    int num_vertices() const {
+        return static_cast<int>(nodes_count);
+    }
+
+    Edge_id_T num_edges() const {
+        return edges_count;
+    }
+
+    int out_degree(Id u) const {
+        return static_cast<int>(offsets[u+1] - offsets[u]);
+    }
+
+    Out_Edges out_edges(Id u) const {
+        return {targets + offsets[u], weights + offsets[u], static_cast<size_t>(offsets[u+1] - offsets[u])};
+    }
+
+    Edge_id_T edges_begin(Id u) const { return offsets[u]; }
+    Edge_id_T edges_end(Id u) const { return offsets[u+1]; }
+    Id target(Edge_id_T e) const { return targets[e]; }
+    Weight weight(Edge_id_T e) const { return weights[e]; }
+
+    // the raw arrays, offsets has num_vertices()+1 entries
+    const Edge_id_T *offsets_data() const { return offsets; }
+    const Id *targets_data() const { return targets; }
+    const Weight *weights_data() const { return weights; }
+
+    // every weight is a non-negative integer, the bucket queue engines need it
+    bool has_integer_weights() const { return integer_weights; }
+    Weight max_weight() const { return max_weight_value; }
+
+    /**
+     * Every weight converts to Other_Weight and back unchanged, the shortest paths of the converted graph are then the
+     * same as long as their lengths fit too
+     */
+    template<typename Other_Weight>
+    bool weights_fit() const {
+        for (Edge_id_T e = 0; e < edges_count; e++) {
+            const Weight w = weights[e];
+            if (w < 0 || static_cast<double>(w) >= static_cast<double>(infinity_of<Other_Weight>())
+                || static_cast<Weight>(static_cast<Other_Weight>(w)) != w) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Graph to_graph() const {
+        Graph G(num_vertices());
+        for (Id u = 0; u < num_vertices(); u++) {
+            for (Edge_id_T e = offsets[u]; e < offsets[u+1]; e++) {
+                boost::add_edge(u, targets[e], static_cast<Dist_T>(weights[e]), G);
+            }
+        }
+        return G;
+    }
+
+    /**
+     * Reverse graph: v->u for every u->v, the in-edges of v are ordered by source
+     */
+    Basic_CSR_Graph transpose() const {
+        const int64_t N = nodes_count;
+        vector<Edge_id_T> in_offsets(N+1, 0);
+        for (Edge_id_T e = 0; e < edges_count; e++) {
+            in_offsets[targets[e]+1]++;
+        }
+        for (int64_t v = 0; v < N; v++) {
+            in_offsets[v+1] += in_offsets[v];
+        }
+
+        vector<Id> sources(edges_count);
+        vector<Weight> in_weights(edges_count);
+        vector<Edge_id_T> next(in_offsets.begin(), in_offsets.end()-1);
+        for (Id u = 0; u < N; u++) {
+            for (Edge_id_T e = offsets[u]; e < offsets[u+1]; e++) {
+                Edge_id_T pos = next[targets[e]]++;
+                sources[pos] = u;
+                in_weights[pos] = weights[e];
+            }
+        }
+        return Basic_CSR_Graph(move(in_offsets), move(sources), move(in_weights));
+    }
+
+private:
+    struct Owned_Arrays {
+        vector<Edge_id_T> offsets;
+        vector<Id> targets;
+        vector<Weight> weights;
+    };
+
+    // the arrays are immutable so copies of the graph share them
+    shared_ptr<const void> holder;
+    int64_t nodes_count = 0;
+    int64_t edges_count = 0;
+    const Edge_id_T *offsets = nullptr;
+    const Id *targets = nullptr;
+    const Weight *weights = nullptr;
+    bool integer_weights = true;
+    Weight max_weight_value = 0;
+
+    void build(const Edge_List *chunks, size_t chunks_count, int64_t N, bool both_directions) {
+        int64_t M = 0;
+        for (size_t c = 0; c < chunks_count; c++) {
+            N = max(N, chunks[c].nodes_count);
+            M += chunks[c].size() * (both_directions ? 2 : 1);
+        }
+
+        auto arrays = make_shared<Owned_Arrays>();
+        auto &offsets = arrays->offsets;
+        offsets.assign(N+1, 0);
+        for (size_t c = 0; c < chunks_count; c++) {
+            const Edge_List &edges = chunks[c];
+            for (int64_t i = 0; i < edges.size(); i++) {
+                offsets[edges.sources[i]+1]++;
+                if (both_directions) {
+                    offsets[edges.targets[i]+1]++;
+                }
+            }
+        }
+        for (int64_t u = 0; u < N; u++) {
+            offsets[u+1] += offsets[u];
+        }
+
+        arrays->targets.resize(M);
+        arrays->weights.resize(M);
+        vector<Edge_id_T> next(offsets.begin(), offsets.end()-1);
+        for (size_t c = 0; c < chunks_count; c++) {
+            const Edge_List &edges = chunks[c];
+            for (int64_t i = 0; i < edges.size(); i++) {
+                const Weight w = static_cast<Weight>(edges.weights[i]);
+                Edge_id_T pos = next[edges.sources[i]]++;
+                arrays->targets[pos] = edges.targets[i];
+                arrays->weights[pos] = w;
+                if (both_directions) {
+                    pos = next[edges.targets[i]]++;
+                    arrays->targets[pos] = edges.sources[i];
+                    arrays->weights[pos] = w;
+                }
+            }
+        }
+        adopt(arrays);
+    }
+
+    void adopt(const shared_ptr<Owned_Arrays> &arrays) {
+        holder = arrays;
+        nodes_count = static_cast<int64_t>(arrays->offsets.size()) - 1;
+        edges_count = static_cast<int64_t>(arrays->targets.size());
+        offsets = arrays->offsets.data();
+        targets = arrays->targets.data();
+        weights = arrays->weights.data();
+        summarize_weights();
+    }
+
+    void summarize_weights() {
+        integer_weights = true;
+        max_weight_value = 0;
+        for (Edge_id_T e = 0; e < edges_count; e++) {
+            const Weight w = weights[e];
+            max_weight_value = max(max_weight_value, w);
+            if (w < 0 || w > 9e15 || w != static_cast<Weight>(static_cast<int64_t>(w))) {
+                integer_weights = false;
+            }
+        }
+    }
+};
+
+using CSR_Graph = Basic_CSR_Graph<Dist_T>;
+using F32_CSR_Graph = Basic_CSR_Graph<float>;
+using U32_CSR_Graph = Basic_CSR_Graph<uint32_t>;
+
+#endif //CSR_GRAPH_HPP
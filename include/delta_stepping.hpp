@@ -0,0 +1,206 @@
+#ifndef DELTA_STEPPING_HPP
+#define DELTA_STEPPING_HPP
+
+#include <vector>
+#include <algorithm>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "utils/thread_pool.hpp"
+
+/*
+ * Delta-stepping: Meyer and Sanders, "Delta-stepping: a parallelizable shortest path algorithm"
+ * The vertices are split between the workers (v belongs to v % threads), each worker keeps the buckets of its vertices.
+ * A phase first turns the edges of the frontier into relaxation requests, grouped by owner, then every owner applies
+ * the requests sent to it: a distance is only ever written by the worker owning the vertex.
+ */
+
+using namespace std;
+
+/**
+ * Max weight over the average out-degree, the usual choice for graphs with random weights.
+ * With integer weights a bucket narrower than 1 would always be empty.
+ */
+template<typename Weight, typename Id>
+Dist_T default_delta(const Basic_CSR_Graph<Weight, Id> &g) {
+    if (g.num_vertices() == 0 || g.num_edges() == 0 || g.max_weight() <= 0) {
+        return 1;
+    }
+    Dist_T avg_degree = static_cast<Dist_T>(g.num_edges()) / g.num_vertices();
+    Dist_T delta = static_cast<Dist_T>(g.max_weight()) / max<Dist_T>(1, avg_degree);
+    return g.has_integer_weights() ? max<Dist_T>(1, delta) : delta;
+}
+
+/**
+ * Scratch memory of delta-stepping bound to one graph and one pool, reused between queries
+ * @tparam Weight weight and distance type of the graph, the bucket width stays a Dist_T
+ */
+template<typename Weight, typename Id = Node_id_T>
+struct Basic_Delta_Stepping_State {
+    using Graph_T = Basic_CSR_Graph<Weight, Id>;
+
+    struct Request {
+        Id v;
+        Id u;
+        Weight length;
+    };
+
+    const Graph_T *graph_ptr;
+    Thread_Pool *pool;
+    Dist_T delta;
+    int threads;
+    vector<int64_t> bucket_of; // bucket currently holding the vertex, -1 for none
+    vector<uint8_t> in_settled;
+    vector<vector<vector<Id>>> buckets; // buckets[owner][i] holds the vertices at distance [i*delta, (i+1)*delta)
+    vector<vector<Id>> frontier; // per owner, vertices taken from the current bucket
+    vector<vector<Id>> settled; // per owner, vertices taken from the current bucket in any of its phases
+    vector<vector<Request>> requests; // requests[worker * T + owner]
+    int64_t min_bucket = 0; // smallest bucket the current phase may insert into
+
+    /**
+     * @param delta bucket width, default_delta(g) when not positive
+     * @param pool must outlive the state and not be running anything else during the queries
+     */
+    Basic_Delta_Stepping_State(const Graph_T &g, Thread_Pool &thread_pool, Dist_T delta = 0) :
+        graph_ptr(&g), pool(&thread_pool), delta(delta > 0 ? delta : default_delta(g)), threads(thread_pool.size()),
+        bucket_of(g.num_vertices(), -1), in_settled(g.num_vertices(), 0),
+        buckets(threads), frontier(threads), settled(threads), requests(static_cast<size_t>(threads) * threads) {}
+
+    // the rounding of length / delta could put v below min_bucket, where it would never be taken again
+    void insert(int owner, Id v, Weight length) {
+        int64_t b = max(static_cast<int64_t>(length / delta), min_bucket);
+        if (bucket_of[v] == b) {
+            return;
+        }
+        bucket_of[v] = b;
+        auto &owned = buckets[owner];
+        if (b >= static_cast<int64_t>(owned.size())) {
+            owned.resize(b+1);
+        }
+        owned[b].push_back(v);
+    }
+
+    // smallest non-empty bucket index >= from, -1 when all are empty
+    int64_t next_bucket(int64_t from) const {
+        int64_t best = -1;
+        for (const auto &owned : buckets) {
+            for (int64_t j = from; j < static_cast<int64_t>(owned.size()) && (best < 0 || j < best); j++) {
+                if (!owned[j].empty()) {
+                    best = j;
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+};
+
+using Delta_Stepping_State = Basic_Delta_Stepping_State<Dist_T>;
+
+/**
+ * Light (weight <= delta) relaxations of the frontier or heavy relaxations of the settled vertices
+ */
+template<typename Weight, typename Id>
+void delta_stepping_phase(Basic_Delta_Stepping_State<Weight, Id> &state, int64_t i, bool light, vector<Weight> &dist,
+                          vector<Id> &parent) {
+    const int T = state.threads;
+    const Dist_T delta = state.delta;
+
+    state.pool->run([&](int w) {
+        for (int o = 0; o < T; o++) {
+            state.requests[w*T + o].clear();
+        }
+        auto &sources = light ? state.frontier[w] : state.settled[w];
+        for (const Id &u : sources) {
+            for (const auto &e : state.graph_ptr->out_edges(u)) {
+                if ((e.w <= delta) == light) {
+                    state.requests[w*T + e.to % T].push_back({e.to, u, saturating_add(dist[u], e.w)});
+                }
+            }
+        }
+        if (!light) { // last phase of the bucket
+            for (const Id &u : sources) {
+                state.in_settled[u] = 0;
+            }
+            sources.clear();
+        }
+    });
+
+    // bucket i is rescanned after a light phase, not after its heavy one
+    state.min_bucket = light ? i : i+1;
+    state.pool->run([&](int o) {
+        for (int w = 0; w < T; w++) {
+            for (const auto &r : state.requests[w*T + o]) {
+                if (r.length < dist[r.v]) {
+                    dist[r.v] = r.length;
+                    parent[r.v] = r.u;
+                    state.insert(o, r.v, r.length);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * Runs delta-stepping from src on the workers of the state's pool
+ * @return distances and parents of the N first vertices
+ */
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> delta_stepping_query(Basic_Delta_Stepping_State<Weight, Id> &state, Id src, int N) {
+    vector<Weight> dist(N, infinity_of<Weight>());
+    vector<Id> parent(N, -1);
+    const int T = state.threads;
+
+    dist[src] = 0;
+    state.min_bucket = 0;
+    state.insert(src % T, src, 0);
+
+    for (int64_t i = state.next_bucket(0); i >= 0; i = state.next_bucket(i+1)) {
+        while (true) {
+            state.pool->run([&](int o) {
+                auto &frontier = state.frontier[o];
+                frontier.clear();
+                if (i >= static_cast<int64_t>(state.buckets[o].size())) {
+                    return;
+                }
+                for (const Id &v : state.buckets[o][i]) {
+                    if (state.bucket_of[v] != i) { // moved to a smaller bucket since
+                        continue;
+                    }
+                    state.bucket_of[v] = -1;
+                    frontier.push_back(v);
+                    if (!state.in_settled[v]) {
+                        state.in_settled[v] = 1;
+                        state.settled[o].push_back(v);
+                    }
+                }
+                state.buckets[o][i].clear();
+            });
+
+            bool has_frontier = false;
+            for (const auto &frontier : state.frontier) {
+                has_frontier |= !frontier.empty();
+            }
+            if (!has_frontier) {
+                break;
+            }
+            delta_stepping_phase(state, i, true, dist, parent);
+        }
+        delta_stepping_phase(state, i, false, dist, parent);
+    }
+
+    return {dist, parent};
+}
+
+/**
+ * @param delta bucket width, default_delta(graph) when not positive
+ * @param threads workers of the relaxation phases
+ */
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> delta_stepping(const Basic_CSR_Graph<Weight, Id> &graph, Id src, int N, Dist_T delta,
+                                                int threads) {
+    Thread_Pool pool(threads);
+    Basic_Delta_Stepping_State<Weight, Id> state(graph, pool, delta);
+    return delta_stepping_query(state, src, N);
+}
+
+#endif //DELTA_STEPPING_HPP
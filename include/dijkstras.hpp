@@ -3,6 +3,8 @@
 
 #include <queue>
 #include "common.hpp"
+#include "csr_graph.hpp"
+#include "data_structures/Indexed_DAry_Heap.hpp"
 
 /*
  *Min heap and Fibonacci heap Dijkstra
@@ -11,18 +13,26 @@
 
 using namespace std;
 
-struct Node {
-    Node_id_T name{};
-    double distance{};
+template<typename Dist, typename Id = Node_id_T>
+struct Basic_Node {
+    Id name{};
+    Dist distance{};
 
-    friend bool operator<(const Node& lhs, const Node& rhs) {
+    friend bool operator<(const Basic_Node& lhs, const Basic_Node& rhs) {
         return lhs.distance >= rhs.distance;
     }
 };
 
-pair<Dist_List_T, Prev_List_T> min_heap_dijkstra(Graph& graph, Node_id_T src, int N) {
-    Dist_List_T dist(N, INF);
-    Prev_List_T parent(N, -1);
+using Node = Basic_Node<Dist_T>;
+
+/**
+ * @return the distances in the graph's weight type, infinity_of<Weight>() for the unreached vertices, and the parents
+ */
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> min_heap_dijkstra(const Basic_CSR_Graph<Weight, Id>& graph, Id src, int N) {
+    using Node = Basic_Node<Weight, Id>;
+    vector<Weight> dist(N, infinity_of<Weight>());
+    vector<Id> parent(N, -1);
     vector<bool> visited(N, false);
 
     priority_queue<Node> min_heap;
@@ -37,11 +47,9 @@ pair<Dist_List_T, Prev_List_T> min_heap_dijkstra(Graph& graph, Node_id_T src, in
         }
         visited[cur.name] = true;
 
-        auto outs = boost::out_edges(cur.name, graph);
-        auto ei = outs.first; auto ei_end = outs.second;
-        for (; ei != ei_end; ++ei) {
-            Node_id_T nei = boost::target(*ei, graph);
-            Dist_T temp = cur.distance + boost::get(boost::edge_weight, graph, *ei);
+        for (const auto &e : graph.out_edges(cur.name)) {
+            Id nei = e.to;
+            Weight temp = saturating_add(cur.distance, e.w);
 
             if (!visited[nei] && temp < dist[nei]) {
                 parent[nei] = cur.name;
@@ -54,15 +62,286 @@ pair<Dist_List_T, Prev_List_T> min_heap_dijkstra(Graph& graph, Node_id_T src, in
     return {dist, parent};
 }
 
+/**
+ * Scratch memory of the binary heap Dijkstra bound to one graph, reused between queries
+ * @tparam Dist weight and distance type of the graph, see F32_Dijkstra_State and U32_Dijkstra_State
+ */
+template<typename Dist, typename Id = Node_id_T>
+struct Basic_Dijkstra_State {
+    using Graph_T = Basic_CSR_Graph<Dist, Id>;
+    const Graph_T *graph_ptr;
+    vector<Basic_Node<Dist, Id>> heap;
+    vector<uint32_t> visited_stamp;
+    uint32_t stamp = 0;
+    size_t peak_heap_size = 0; // of the last query, stale entries included
+
+    explicit Basic_Dijkstra_State(const Graph_T &g): graph_ptr(&g), visited_stamp(g.num_vertices(), 0) {}
+
+    void reset() {
+        heap.clear();
+        peak_heap_size = 0;
+        if (++stamp == 0) { // wrapped around, old stamps could be mistaken for the current one
+            fill(visited_stamp.begin(), visited_stamp.end(), 0);
+            stamp = 1;
+        }
+    }
+};
+
+using Dijkstra_State = Basic_Dijkstra_State<Dist_T>;
+using F32_Dijkstra_State = Basic_Dijkstra_State<float>;
+using U32_Dijkstra_State = Basic_Dijkstra_State<uint32_t>;
+
+/**
+ * Same as min_heap_dijkstra but the heap storage and the visited marks come from state
+ * @return the distances in the graph's type, infinity_of<Dist>() for the unreached vertices
+ */
+template<typename Dist, typename Id>
+pair<vector<Dist>, vector<Id>> dijkstra_query(Basic_Dijkstra_State<Dist, Id> &state, Id src, int N) {
+    using Node = Basic_Node<Dist, Id>;
+    state.reset();
+    vector<Dist> dist(N, infinity_of<Dist>());
+    vector<Id> parent(N, -1);
+    auto &heap = state.heap;
+    auto &visited = state.visited_stamp;
+
+    dist[src] = 0;
+    heap.push_back(Node{src, dist[src]});
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end());
+        Node cur = heap.back();
+        heap.pop_back();
+        if (visited[cur.name] == state.stamp) {
+            continue;
+        }
+        visited[cur.name] = state.stamp;
+
+        for (const auto &e : state.graph_ptr->out_edges(cur.name)) {
+            Id nei = e.to;
+            Dist temp = saturating_add(cur.distance, e.w);
+
+            if (visited[nei] != state.stamp && temp < dist[nei]) {
+                parent[nei] = cur.name;
+                dist[nei] = temp;
+                heap.push_back(Node{nei, dist[nei]});
+                push_heap(heap.begin(), heap.end());
+                state.peak_heap_size = max(state.peak_heap_size, heap.size());
+            }
+        }
+    }
+
+    return {dist, parent};
+}
+
+/**
+ * Scratch memory of the indexed heap Dijkstra: every vertex is at most once in the heap and improvements are
+ * decrease-keys instead of new entries
+ * @tparam D arity of the heap
+ */
+template<int D = 4, typename Weight = Dist_T, typename Id = Node_id_T>
+struct Indexed_Dijkstra_State {
+    using Graph_T = Basic_CSR_Graph<Weight, Id>;
+    const Graph_T *graph_ptr;
+    Indexed_DAry_Heap<Weight, D> heap;
+    size_t peak_heap_size = 0; // of the last query
+
+    explicit Indexed_Dijkstra_State(const Graph_T &g): graph_ptr(&g), heap(g.num_vertices()) {}
+};
+
+template<int D, typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> indexed_dijkstra_query(Indexed_Dijkstra_State<D, Weight, Id> &state, Id src, int N) {
+    vector<Weight> dist(N, infinity_of<Weight>());
+    vector<Id> parent(N, -1);
+    auto &heap = state.heap;
+    heap.clear();
+    heap.reset_peak();
+
+    dist[src] = 0;
+    heap.push_or_decrease(src, 0);
+
+    while (!heap.empty()) {
+        const Weight d = heap.top_key();
+        const Id u = heap.pop();
+
+        for (const auto &e : state.graph_ptr->out_edges(u)) {
+            Weight temp = saturating_add(d, e.w);
+            if (temp < dist[e.to]) { // never true for a settled vertex
+                parent[e.to] = u;
+                dist[e.to] = temp;
+                heap.push_or_decrease(e.to, temp);
+            }
+        }
+    }
+
+    state.peak_heap_size = heap.peak_size();
+    return {dist, parent};
+}
+
+/**
+ * Dijkstra on an indexed D-ary heap with decrease-key
+ */
+template<int D = 4, typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> indexed_heap_dijkstra(const Basic_CSR_Graph<Weight, Id>& graph, Id src, int N) {
+    Indexed_Dijkstra_State<D, Weight, Id> state(graph);
+    return indexed_dijkstra_query(state, src, N);
+}
+
+/*
+ * Monotone bucket queues for non-negative integer weights, see CSR_Graph::has_integer_weights
+ * Dial: https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm#Specialized_variants
+ * Radix heap: Ahuja, Mehlhorn, Orlin, Tarjan, "Faster algorithms for the shortest path problem"
+ */
+
+// largest weight for which Dial's circular array of max_weight+1 buckets is used, above it the radix heap is
+constexpr int64_t DIAL_MAX_WEIGHT = 1 << 12;
+
+/**
+ * Dial's algorithm: distances are settled bucket by bucket, the bucket of d is buckets[d % (max_weight+1)]
+ */
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> dial_dijkstra(const Basic_CSR_Graph<Weight, Id>& graph, Id src, int N) {
+    const int64_t C = static_cast<int64_t>(graph.max_weight()) + 1;
+    vector<Weight> dist(N, infinity_of<Weight>());
+    vector<Id> parent(N, -1);
+    vector<vector<Id>> buckets(C);
+
+    dist[src] = 0;
+    buckets[0].push_back(src);
+    int64_t pending = 1;
+
+    for (int64_t cur_d = 0; pending > 0; cur_d++) {
+        auto &bucket = buckets[cur_d % C];
+        while (!bucket.empty()) { // zero weight edges refill the current bucket
+            Id u = bucket.back();
+            bucket.pop_back();
+            pending--;
+            if (dist[u] != static_cast<Weight>(cur_d)) { // outdated entry
+                continue;
+            }
+
+            for (const auto &e : graph.out_edges(u)) {
+                int64_t temp = cur_d + static_cast<int64_t>(e.w);
+                if (temp < dist[e.to]) { // never true past the integer infinity_of<Weight>()
+                    parent[e.to] = u;
+                    dist[e.to] = temp;
+                    buckets[temp % C].push_back(e.to);
+                    pending++;
+                }
+            }
+        }
+    }
+
+    return {dist, parent};
+}
+
+/**
+ * Monotone priority queue on integer keys, the keys pushed can't be smaller than the last key popped.
+ * Bucket i holds the keys whose highest bit differing from the last popped key is bit i-1.
+ */
+template<typename Id = Node_id_T>
+class Basic_Radix_Heap {
+public:
+    using Item = pair<uint64_t, Id>;
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void push(uint64_t key, Id v) {
+        buckets[bucket_of(key)].emplace_back(key, v);
+        count++;
+    }
+
+    Item pop() {
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) {
+                i++;
+            }
+            last = buckets[i].front().first;
+            for (const Item &p : buckets[i]) {
+                last = min(last, p.first);
+            }
+            for (const Item &p : buckets[i]) {
+                buckets[bucket_of(p.first)].push_back(p);
+            }
+            buckets[i].clear();
+        }
+        Item top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return top;
+    }
+
+private:
+    vector<Item> buckets[65];
+    uint64_t last = 0;
+    size_t count = 0;
+
+    int bucket_of(uint64_t key) const {
+        return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+    }
+};
+
+using Radix_Heap = Basic_Radix_Heap<>;
+
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> radix_heap_dijkstra(const Basic_CSR_Graph<Weight, Id>& graph, Id src, int N) {
+    vector<Weight> dist(N, infinity_of<Weight>());
+    vector<Id> parent(N, -1);
+    vector<bool> visited(N, false);
+
+    Basic_Radix_Heap<Id> heap;
+    dist[src] = 0;
+    heap.push(0, src);
+
+    while (!heap.empty()) {
+        auto cur = heap.pop();
+        Id u = cur.second;
+        if (visited[u]) {
+            continue;
+        }
+        visited[u] = true;
+
+        for (const auto &e : graph.out_edges(u)) {
+            uint64_t temp = cur.first + static_cast<uint64_t>(e.w);
+            if (!visited[e.to] && temp < dist[e.to]) {
+                parent[e.to] = u;
+                dist[e.to] = temp;
+                heap.push(temp, e.to);
+            }
+        }
+    }
+
+    return {dist, parent};
+}
+
+/**
+ * Picks the engine from the weights of graph: Dial for small integer weights, the radix heap for wider integer
+ * weights and min_heap_dijkstra otherwise
+ */
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> bucket_dijkstra(const Basic_CSR_Graph<Weight, Id>& graph, Id src, int N) {
+    if (!graph.has_integer_weights()) {
+        return min_heap_dijkstra(graph, src, N);
+    }
+    if (graph.max_weight() <= DIAL_MAX_WEIGHT) {
+        return dial_dijkstra(graph, src, N);
+    }
+    return radix_heap_dijkstra(graph, src, N);
+}
+
 
 #include <boost/heap/fibonacci_heap.hpp>
 
-pair<Dist_List_T, Prev_List_T> fibo_heap_dijkstra(Graph& graph, Node_id_T src, int N) { //TODO make this similar to boost
+template<typename Weight, typename Id>
+pair<vector<Weight>, vector<Id>> fibo_heap_dijkstra(const Basic_CSR_Graph<Weight, Id>& graph, Id src, int N) { //TODO make this similar to boost
+    using Node = Basic_Node<Weight, Id>;
     using Heap = boost::heap::fibonacci_heap<Node>;
-    using Handle = Heap::handle_type;
+    using Handle = typename Heap::handle_type;
 
-    Dist_List_T dist(N, INF);
-    Prev_List_T parent(N, -1);
+    vector<Weight> dist(N, infinity_of<Weight>());
+    vector<Id> parent(N, -1);
     vector<bool> visited(N, false);
     dist[src] = 0;
 
@@ -78,11 +357,9 @@ pair<Dist_List_T, Prev_List_T> fibo_heap_dijkstra(Graph& graph, Node_id_T src, i
         }
         visited[cur.name] = true;
 
-        auto outs = boost::out_edges(cur.name, graph);
-        auto ei = outs.first; auto ei_end = outs.second;
-        for (; ei != ei_end; ++ei) {
-            Node_id_T nei = boost::target(*ei, graph);
-            Dist_T temp = cur.distance + boost::get(boost::edge_weight, graph, *ei);
+        for (const auto &e : graph.out_edges(cur.name)) {
+            Id nei = e.to;
+            Weight temp = saturating_add(cur.distance, e.w);
 
             if (!visited[nei] && temp < dist[nei]) {
                 parent[nei] = cur.name;
@@ -0,0 +1,299 @@
+#ifndef DYNAMIC_SSSP_HPP
+#define DYNAMIC_SSSP_HPP
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "dijkstras.hpp"
+
+/*
+ * Dynamic SSSP in the style of Ramalingam and Reps: a shortest path tree is repaired after a batch of edge updates
+ * instead of being recomputed. The tree edges made longer or deleted cut subtrees off, their vertices are reset and
+ * seeded from their in-edges leaving the subtrees, the edges made shorter or inserted seed their target. One Dijkstra
+ * from all the seeds then only settles vertices whose distance changes, or that belonged to a cut subtree.
+ * When the shortest paths are unique the cut subtrees are exactly the vertices whose distance grows, with ties some of
+ * their vertices get their old distance back.
+ * src: G. Ramalingam, T. Reps, "An incremental algorithm for a generalization of the shortest-path problem", 1996
+ */
+
+using namespace std;
+
+/**
+ * New weight of the edge from -> to, it is inserted when missing and deleted with infinity_of<Weight>(). The parallel
+ * edges from -> to are replaced by this one.
+ */
+template<typename Weight, typename Id = Node_id_T>
+struct Basic_Edge_Update {
+    Id from;
+    Id to;
+    Weight weight;
+};
+
+using Edge_Update = Basic_Edge_Update<Dist_T>;
+
+/**
+ * Graph and shortest path tree of one source, kept up to date by dynamic_sssp_update. The graph is held as out and in
+ * adjacency lists so an update only touches the lists of its endpoints.
+ */
+template<typename Weight, typename Id = Node_id_T>
+struct Basic_Dynamic_SSSP_State {
+    using Graph_T = Basic_CSR_Graph<Weight, Id>;
+    using Edge_T = Basic_Edge<Weight, Id>;
+
+    vector<vector<Edge_T>> out, in; // in[v] holds Edge_T(u, w) for every edge u -> v
+    Id src;
+    vector<Weight> dist;
+    vector<Id> parent;
+    vector<Id> changed; // vertices whose distance changed in the last update
+
+    // scratch of the updates
+    vector<uint32_t> mark; // stamp: in a cut subtree, stamp+1: distance lowered outside of them
+    uint32_t stamp = 0;
+    vector<Id> cut;
+    vector<Weight> cut_dist; // distance of cut[i] before the update
+    vector<Basic_Node<Weight, Id>> heap;
+
+    /**
+     * @param result distances and parents of src in g from any of the engines, the parents must form a shortest path
+     * tree
+     */
+    Basic_Dynamic_SSSP_State(const Graph_T &g, Id src, const pair<vector<Weight>, vector<Id>> &result) :
+        out(g.num_vertices()), in(g.num_vertices()), src(src), dist(result.first), parent(result.second),
+        mark(g.num_vertices(), 0) {
+        const Graph_T reverse = g.transpose();
+        for (Id u = 0; u < g.num_vertices(); u++) {
+            for (const Edge_T &e : g.out_edges(u)) {
+                out[u].push_back(e);
+            }
+            for (const Edge_T &e : reverse.out_edges(u)) {
+                in[u].push_back(e);
+            }
+            // boost_dijkstra makes the source and the unreached vertices their own parent
+            if (u == src || dist[u] == infinity_of<Weight>() || parent[u] == u) {
+                parent[u] = -1;
+            }
+        }
+    }
+
+    int num_vertices() const {
+        return static_cast<int>(out.size());
+    }
+
+    // the updated graph
+    Graph_T to_csr_graph() const {
+        Edge_List edges(num_vertices());
+        for (Id u = 0; u < num_vertices(); u++) {
+            for (const Edge_T &e : out[u]) {
+                edges.add_edge(u, e.to, e.w);
+            }
+        }
+        return Graph_T(edges);
+    }
+
+    // new vertices are unreached
+    void grow(int n) {
+        if (n > num_vertices()) {
+            out.resize(n);
+            in.resize(n);
+            dist.resize(n, infinity_of<Weight>());
+            parent.resize(n, -1);
+            mark.resize(n, 0);
+        }
+    }
+
+    void next_stamp() {
+        stamp += 2;
+        if (stamp == 0 || stamp + 1 == 0) { // wrapped around, old stamps could be mistaken for the current ones
+            fill(mark.begin(), mark.end(), 0);
+            stamp = 2;
+        }
+    }
+};
+
+using Dynamic_SSSP_State = Basic_Dynamic_SSSP_State<Dist_T>;
+
+/**
+ * Removes the edges to -> target of list
+ */
+template<typename Weight, typename Id>
+void remove_edges_to(vector<Basic_Edge<Weight, Id>> &list, Id target) {
+    list.erase(remove_if(list.begin(), list.end(), [target](const Basic_Edge<Weight, Id> &e) { return e.to == target; }),
+               list.end());
+}
+
+/**
+ * Lightest edge from -> to in the current graph of state, infinity_of<Weight>() when there is none
+ */
+template<typename Weight, typename Id>
+Weight edge_weight(const Basic_Dynamic_SSSP_State<Weight, Id> &state, Id from, Id to) {
+    Weight w = infinity_of<Weight>();
+    for (const auto &e : state.out[from]) {
+        if (e.to == to) {
+            w = min(w, e.w);
+        }
+    }
+    return w;
+}
+
+/**
+ * Applies the updates to the graph of state, in order, and repairs its distances and parents
+ * @return the number of vertices whose distance changed, they are listed in state.changed
+ */
+template<typename Weight, typename Id>
+size_t dynamic_sssp_update(Basic_Dynamic_SSSP_State<Weight, Id> &state, const vector<Basic_Edge_Update<Weight, Id>> &updates) {
+    const Weight inf = infinity_of<Weight>();
+    auto &dist = state.dist;
+    auto &parent = state.parent;
+    auto &mark = state.mark;
+    for (const auto &up : updates) {
+        if (up.from < 0 || up.to < 0 || up.weight < 0) {
+            throw invalid_argument("Edge updates need non negative vertices and weights");
+        }
+        state.grow(max(up.from, up.to) + 1);
+    }
+    state.next_stamp();
+    const uint32_t in_cut = state.stamp, lowered = state.stamp + 1;
+
+    for (const auto &up : updates) {
+        remove_edges_to(state.out[up.from], up.to);
+        remove_edges_to(state.in[up.to], up.from);
+        if (up.weight < inf) {
+            state.out[up.from].emplace_back(up.to, up.weight);
+            state.in[up.to].emplace_back(up.from, up.weight);
+        }
+    }
+
+    // the tree edges that got longer or were deleted cut their subtree off
+    auto &cut = state.cut;
+    cut.clear();
+    for (const auto &up : updates) {
+        const Id v = up.to;
+        if (parent[v] == up.from && mark[v] != in_cut
+            && saturating_add(dist[up.from], edge_weight(state, up.from, v)) > dist[v]) {
+            mark[v] = in_cut;
+            cut.push_back(v);
+        }
+    }
+    for (size_t i = 0; i < cut.size(); i++) {
+        const Id x = cut[i];
+        for (const auto &e : state.out[x]) {
+            if (parent[e.to] == x && mark[e.to] != in_cut) {
+                mark[e.to] = in_cut;
+                cut.push_back(e.to);
+            }
+        }
+    }
+
+    state.cut_dist.clear();
+    for (const Id &v : cut) {
+        state.cut_dist.push_back(dist[v]);
+        dist[v] = inf;
+        parent[v] = -1;
+    }
+
+    auto &heap = state.heap;
+    heap.clear();
+    auto push = [&heap](Id v, Weight d) {
+        heap.push_back({v, d});
+        push_heap(heap.begin(), heap.end());
+    };
+
+    // seeds: the cut vertices from the rest of the tree, the targets of the shorter edges
+    for (const Id &v : cut) {
+        for (const auto &e : state.in[v]) {
+            if (mark[e.to] != in_cut && saturating_add(dist[e.to], e.w) < dist[v]) {
+                dist[v] = saturating_add(dist[e.to], e.w);
+                parent[v] = e.to;
+            }
+        }
+        if (dist[v] < inf) {
+            push(v, dist[v]);
+        }
+    }
+    state.changed.clear();
+    auto lower = [&](Id v, Weight d, Id p) {
+        dist[v] = d;
+        parent[v] = p;
+        if (mark[v] != in_cut && mark[v] != lowered) {
+            mark[v] = lowered;
+            state.changed.push_back(v);
+        }
+        push(v, d);
+    };
+    for (const auto &up : updates) {
+        const Weight temp = saturating_add(dist[up.from], edge_weight(state, up.from, up.to));
+        if (temp < dist[up.to]) {
+            lower(up.to, temp, up.from);
+        }
+    }
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end());
+        auto cur = heap.back();
+        heap.pop_back();
+        if (cur.distance > dist[cur.name]) { // stale entry
+            continue;
+        }
+        for (const auto &e : state.out[cur.name]) {
+            Weight temp = saturating_add(cur.distance, e.w);
+            if (temp < dist[e.to]) {
+                lower(e.to, temp, cur.name);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < cut.size(); i++) {
+        if (dist[cut[i]] != state.cut_dist[i]) {
+            state.changed.push_back(cut[i]);
+        }
+    }
+    return state.changed.size();
+}
+
+/**
+ * The updates turning the graph before into after, both must number the vertices the same way. Only the lightest of
+ * parallel edges matters to the shortest paths so they become one edge.
+ */
+template<typename Weight, typename Id>
+vector<Basic_Edge_Update<Weight, Id>> edge_updates_between(const Basic_CSR_Graph<Weight, Id> &before,
+                                                           const Basic_CSR_Graph<Weight, Id> &after) {
+    vector<Basic_Edge_Update<Weight, Id>> updates;
+    vector<pair<Id, Weight>> old_edges, new_edges;
+    auto lightest = [](const Basic_CSR_Graph<Weight, Id> &g, Id u, vector<pair<Id, Weight>> &edges) {
+        edges.clear();
+        if (u < g.num_vertices()) {
+            for (const auto &e : g.out_edges(u)) {
+                edges.emplace_back(e.to, e.w);
+            }
+        }
+        sort(edges.begin(), edges.end());
+        edges.erase(unique(edges.begin(), edges.end(), [](const auto &a, const auto &b) { return a.first == b.first; }),
+                    edges.end());
+    };
+
+    const Id N = max(before.num_vertices(), after.num_vertices());
+    for (Id u = 0; u < N; u++) {
+        lightest(before, u, old_edges);
+        lightest(after, u, new_edges);
+        size_t i = 0, j = 0;
+        while (i < old_edges.size() || j < new_edges.size()) {
+            if (j == new_edges.size() || (i < old_edges.size() && old_edges[i].first < new_edges[j].first)) {
+                updates.push_back({u, old_edges[i++].first, infinity_of<Weight>()});
+            } else if (i == old_edges.size() || new_edges[j].first < old_edges[i].first) {
+                updates.push_back({u, new_edges[j].first, new_edges[j].second});
+                j++;
+            } else {
+                if (old_edges[i].second != new_edges[j].second) {
+                    updates.push_back({u, new_edges[j].first, new_edges[j].second});
+                }
+                i++;
+                j++;
+            }
+        }
+    }
+    return updates;
+}
+
+#endif //DYNAMIC_SSSP_HPP
@@ -0,0 +1,178 @@
+#ifndef MANY_TO_MANY_HPP
+#define MANY_TO_MANY_HPP
+
+#include <atomic>
+#include <stdexcept>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "dijkstras.hpp"
+#include "bounded_sssp.hpp"
+#include "utils/thread_pool.hpp"
+
+/*
+ * Distances from a set of sources to a set of targets. Each source runs a Dijkstra that stops once all the targets are
+ * settled and writes their distances straight into its row of the matrix, the sources are spread over the threads
+ * with one Bounded_Dijkstra_State per worker.
+ */
+
+using namespace std;
+
+/**
+ * Dense rows x cols matrix stored in square tiles of TILE x TILE distances, tile after tile. A tile is 8 KB so the
+ * tiles of a column band stay in cache while a column is read, and the row segments are 256 bytes so the workers
+ * writing different rows only share the cache lines at their ends. The missing distances are INF.
+ */
+class Distance_Matrix {
+public:
+    static constexpr int TILE = 32;
+
+    Distance_Matrix() = default;
+
+    Distance_Matrix(int rows, int cols) : rows_count(rows), cols_count(cols), tiles_per_row((cols + TILE - 1) / TILE),
+        data(static_cast<size_t>((rows + TILE - 1) / TILE) * tiles_per_row * TILE * TILE, INF) {}
+
+    int rows() const {
+        return rows_count;
+    }
+
+    int cols() const {
+        return cols_count;
+    }
+
+    Dist_T at(int r, int c) const {
+        return data[index(r, c)];
+    }
+
+    Dist_T &at(int r, int c) {
+        return data[index(r, c)];
+    }
+
+    Dist_List_T row(int r) const {
+        Dist_List_T sortie(cols_count);
+        for (int c = 0; c < cols_count; c++) {
+            sortie[c] = at(r, c);
+        }
+        return sortie;
+    }
+
+    Dist_List_T col(int c) const {
+        Dist_List_T sortie(rows_count);
+        for (int r = 0; r < rows_count; r++) {
+            sortie[r] = at(r, c);
+        }
+        return sortie;
+    }
+
+private:
+    int rows_count = 0;
+    int cols_count = 0;
+    int tiles_per_row = 0;
+    Dist_List_T data;
+
+    size_t index(int r, int c) const {
+        const size_t tile = static_cast<size_t>(r / TILE) * tiles_per_row + c / TILE;
+        return tile * TILE * TILE + (r % TILE) * TILE + c % TILE;
+    }
+};
+
+/**
+ * Columns of the targets by vertex, a vertex listed several times as target has a chain of columns
+ */
+struct Target_Columns {
+    vector<int> first; // first column of each vertex, -1 when it isn't a target
+    vector<int> next; // next column of the same vertex, -1 at the end of the chain
+    size_t distinct = 0;
+
+    Target_Columns(int n, const vector<Node_id_T> &targets) : first(n, -1), next(targets.size(), -1) {
+        for (int c = static_cast<int>(targets.size()) - 1; c >= 0; c--) {
+            if (first[targets[c]] == -1) {
+                distinct++;
+            }
+            next[c] = first[targets[c]];
+            first[targets[c]] = c;
+        }
+    }
+};
+
+/**
+ * Dijkstra from src until every target is settled, their distances go to row r of matrix. The parents are not kept.
+ */
+void many_to_many_row(Bounded_Dijkstra_State &state, Node_id_T src, const Target_Columns &targets,
+                      Distance_Matrix &matrix, int r) {
+    state.reset();
+    auto &dist = state.dist;
+    auto &heap = state.heap;
+    size_t remaining = targets.distinct;
+
+    dist[src] = 0;
+    state.touched.push_back(src);
+    heap.push_back(Node{src, 0});
+
+    while (!heap.empty() && remaining > 0) {
+        pop_heap(heap.begin(), heap.end());
+        Node cur = heap.back();
+        heap.pop_back();
+        if (cur.distance > dist[cur.name]) { // stale entry
+            continue;
+        }
+        if (targets.first[cur.name] != -1) {
+            for (int c = targets.first[cur.name]; c != -1; c = targets.next[c]) {
+                matrix.at(r, c) = cur.distance;
+            }
+            remaining--;
+        }
+
+        for (const Edge &e : state.graph_ptr->out_edges(cur.name)) {
+            Dist_T temp = cur.distance + e.w;
+            if (temp < dist[e.to]) {
+                if (dist[e.to] == INF) {
+                    state.touched.push_back(e.to);
+                }
+                dist[e.to] = temp;
+                heap.push_back(Node{e.to, temp});
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+}
+
+/**
+ * Distances from every source to every target on the threads of pool, matrix.at(i, j) is the distance from sources[i]
+ * to targets[j]
+ */
+Distance_Matrix many_to_many(const CSR_Graph &g, const vector<Node_id_T> &sources, const vector<Node_id_T> &targets,
+                             Thread_Pool &pool) {
+    const int N = g.num_vertices();
+    for (const vector<Node_id_T> *list : {&sources, &targets}) {
+        for (const Node_id_T &v : *list) {
+            if (v < 0 || v >= N) {
+                throw invalid_argument("Many-to-many vertex out of range: " + to_string(v));
+            }
+        }
+    }
+
+    Distance_Matrix matrix(sources.size(), targets.size());
+    const Target_Columns columns(N, targets);
+    atomic<size_t> next{0};
+
+    pool.run([&](int) {
+        size_t i = next++;
+        if (i >= sources.size()) {
+            return;
+        }
+        Bounded_Dijkstra_State state(g); // built only by the workers that get some work
+
+        for (; i < sources.size(); i = next++) {
+            many_to_many_row(state, sources[i], columns, matrix, i);
+        }
+    });
+    return matrix;
+}
+
+Distance_Matrix many_to_many(const CSR_Graph &g, const vector<Node_id_T> &sources, const vector<Node_id_T> &targets,
+                             int threads = 1) {
+    Thread_Pool pool(min(threads, max(1, static_cast<int>(sources.size()))));
+    return many_to_many(g, sources, targets, pool);
+}
+
+#endif //MANY_TO_MANY_HPP
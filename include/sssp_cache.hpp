@@ -0,0 +1,192 @@
+#ifndef SSSP_CACHE_HPP
+#define SSSP_CACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include "common.hpp"
+#include "csr_graph.hpp"
+#include "bmssp.hpp"
+#include "bmssp_autotune.hpp"
+
+/*
+ * Cache of SSSP results in front of the engines, for query mixes where a few sources come back often. The results are
+ * keyed by the fingerprint of their graph and their source, and evicted least recently used first once their size
+ * passes the memory budget. The results are shared and immutable: a hit costs no copy and an evicted result stays
+ * alive for the readers still holding it.
+ */
+
+using namespace std;
+
+struct SSSP_Cache_Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+
+    double hit_rate() const {
+        return hits + misses == 0 ? 0 : static_cast<double>(hits) / (hits + misses);
+    }
+};
+
+/**
+ * LRU cache of the results of (graph fingerprint, source), thread-safe. The lookups move their entry to the front of
+ * the LRU list so they take the lock too, the counters are atomics readable without it.
+ */
+class SSSP_Cache {
+public:
+    using Result_Ptr = shared_ptr<const SSSP_Result>;
+
+    /**
+     * @param budget_bytes memory of the cached distances and parents, a result bigger than that is not kept
+     */
+    explicit SSSP_Cache(size_t budget_bytes) : budget(budget_bytes) {}
+
+    SSSP_Cache(const SSSP_Cache&) = delete;
+    SSSP_Cache& operator=(const SSSP_Cache&) = delete;
+
+    static size_t size_of(const SSSP_Result &result) {
+        return result.first.capacity() * sizeof(Dist_T) + result.second.capacity() * sizeof(Node_id_T);
+    }
+
+    /**
+     * @return the cached result, nullptr when missing
+     */
+    Result_Ptr get(uint64_t fingerprint, Node_id_T src) {
+        {
+            lock_guard<mutex> lock(mtx);
+            auto it = index.find(Key{fingerprint, src});
+            if (it != index.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                hits_count++;
+                return it->second->result;
+            }
+        }
+        misses_count++;
+        return nullptr;
+    }
+
+    /**
+     * Caches result, replacing the previous one of the same key, and evicts the least recently used results over the
+     * budget
+     * @return the shared result
+     */
+    Result_Ptr put(uint64_t fingerprint, Node_id_T src, SSSP_Result result) {
+        result.first.shrink_to_fit();
+        result.second.shrink_to_fit();
+        const size_t size = size_of(result);
+        Result_Ptr shared = make_shared<const SSSP_Result>(move(result));
+        if (size > budget) {
+            return shared;
+        }
+
+        lock_guard<mutex> lock(mtx);
+        const Key key{fingerprint, src};
+        auto it = index.find(key);
+        if (it != index.end()) {
+            used -= it->second->size;
+            lru.erase(it->second);
+            index.erase(it);
+        }
+        lru.push_front(Entry{key, shared, size});
+        index[key] = lru.begin();
+        used += size;
+        while (used > budget) {
+            used -= lru.back().size;
+            index.erase(lru.back().key);
+            lru.pop_back();
+            evictions_count++;
+        }
+        bytes_used = used;
+        entries_count = lru.size();
+        return shared;
+    }
+
+    /**
+     * The cached result or compute()'s, cached. compute runs without the lock: concurrent misses of the same key both
+     * compute it and the last one is kept.
+     */
+    Result_Ptr get_or_compute(uint64_t fingerprint, Node_id_T src, const function<SSSP_Result()> &compute) {
+        Result_Ptr cached = get(fingerprint, src);
+        return cached ? cached : put(fingerprint, src, compute());
+    }
+
+    void clear() {
+        lock_guard<mutex> lock(mtx);
+        lru.clear();
+        index.clear();
+        used = 0;
+        bytes_used = 0;
+        entries_count = 0;
+    }
+
+    SSSP_Cache_Stats stats() const {
+        SSSP_Cache_Stats sortie;
+        sortie.hits = hits_count;
+        sortie.misses = misses_count;
+        sortie.evictions = evictions_count;
+        sortie.entries = entries_count;
+        sortie.bytes = bytes_used;
+        return sortie;
+    }
+
+private:
+    struct Key {
+        uint64_t fingerprint;
+        Node_id_T src;
+
+        bool operator==(const Key &other) const {
+            return fingerprint == other.fingerprint && src == other.src;
+        }
+    };
+
+    struct Key_Hash {
+        size_t operator()(const Key &key) const {
+            return hash<uint64_t>()(key.fingerprint ^ (static_cast<uint64_t>(key.src) * 0x9e3779b97f4a7c15ull));
+        }
+    };
+
+    struct Entry {
+        Key key;
+        Result_Ptr result;
+        size_t size;
+    };
+
+    const size_t budget;
+    mutex mtx;
+    list<Entry> lru; // most recently used first
+    unordered_map<Key, list<Entry>::iterator, Key_Hash> index;
+    size_t used = 0; // guarded by mtx
+    atomic<size_t> hits_count{0}, misses_count{0}, evictions_count{0}, entries_count{0}, bytes_used{0};
+};
+
+/**
+ * BMSSP behind a cache for one graph, the fingerprint is computed once here
+ */
+class Cached_SSSP {
+public:
+    Cached_SSSP(const CSR_Graph &g, SSSP_Cache &cache, BMSSP_Params params = BMSSP_Params()) :
+        graph_ptr(&g), cache_ptr(&cache), params(params), graph_hash(graph_fingerprint(g)) {}
+
+    SSSP_Cache::Result_Ptr query(Node_id_T src) const {
+        return cache_ptr->get_or_compute(graph_hash, src, [this, src]() {
+            return top_level_BMSSP_with_params(*graph_ptr, src, graph_ptr->num_vertices(), params);
+        });
+    }
+
+    uint64_t fingerprint() const {
+        return graph_hash;
+    }
+
+private:
+    const CSR_Graph *graph_ptr;
+    SSSP_Cache *cache_ptr;
+    BMSSP_Params params;
+    uint64_t graph_hash;
+};
+
+#endif //SSSP_CACHE_HPP
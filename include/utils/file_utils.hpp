@@ -3,8 +3,16 @@
 
 #include <fstream>
 #include <string>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <boost/graph/graphml.hpp>
 #include "../common.hpp"
+#include "../csr_graph.hpp"
+#include "stream_parser.hpp"
 
 using namespace std;
 
@@ -35,6 +43,41 @@ struct BGP_Info {
     }
 };
 
+/**
+ * Header of the binary CSR snapshots. It is followed by the offsets (int64, nodes_count+1), the targets
+ * (int32, edges_count), zero padding to 8 bytes and the weights (double, edges_count), in the native byte order.
+ */
+struct CSR_Snapshot_Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int64_t nodes_count;
+    int64_t edges_count;
+    double max_weight;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(CSR_Snapshot_Header) == 64, "the snapshot header is 64 bytes");
+
+constexpr char CSR_SNAPSHOT_MAGIC[8] = {'B', 'M', 'S', 'S', 'P', 'C', 'S', 'R'};
+constexpr uint32_t CSR_SNAPSHOT_VERSION = 1;
+constexpr uint32_t CSR_SNAPSHOT_INTEGER_WEIGHTS = 1; // flags bit
+
+// byte positions of the arrays in a snapshot
+struct CSR_Snapshot_Layout {
+    size_t offsets_pos;
+    size_t targets_pos;
+    size_t weights_pos;
+    size_t size;
+
+    CSR_Snapshot_Layout(int64_t nodes_count, int64_t edges_count) {
+        offsets_pos = sizeof(CSR_Snapshot_Header);
+        targets_pos = offsets_pos + (nodes_count+1) * sizeof(CSR_Graph::Edge_id_T);
+        weights_pos = targets_pos + edges_count * sizeof(Node_id_T);
+        weights_pos = (weights_pos + alignof(Dist_T) - 1) / alignof(Dist_T) * alignof(Dist_T);
+        size = weights_pos + edges_count * sizeof(Dist_T);
+    }
+};
+
 class FileUtils {
 public:
     template<typename Info>
@@ -74,6 +117,189 @@ public:
         return read_graphml<BGP_Info>(filename, verbose);
     }
 
+    /**
+     * Parallel streaming reader of "src dst [weight]" lines, the vertices are the integers found in the file
+     * @param undirected also add dst->src for every line
+     * @return the graph and the ingestion speed
+     */
+    static pair<CSR_Graph, Ingest_Stats> stream_edge_list(const string &filename, int threads, bool undirected=false,
+                                                          bool verbose=false, size_t block_size=STREAM_BLOCK_SIZE) {
+        auto start = chrono::steady_clock::now();
+        Thread_Pool pool(threads);
+        vector<Edge_List> chunks;
+        int64_t nodes_count = 0;
+
+        stream_blocks(filename, block_size, edge_list_complete_until, [&](const string &text, size_t end) {
+            auto cuts = split_at_records(text, end, pool.size(), edge_list_next_line);
+            vector<Edge_List> pieces(pool.size());
+            pool.run([&](int i) {
+                parse_edge_list_piece(text, cuts[i], cuts[i+1], pieces[i]);
+            });
+            for (auto &piece : pieces) {
+                nodes_count = max(nodes_count, piece.nodes_count);
+                chunks.push_back(move(piece));
+            }
+        });
+
+        return finish_stream(filename, chunks, nodes_count, undirected, start, verbose);
+    }
+
+    /**
+     * Parallel streaming GraphML reader, gives the same graph as read_graphml: both directions of every edge and the
+     * vertices numbered in order of first appearance
+     * @param weight_attr attr.name of the edge key holding the weight, default_weight when an edge has none
+     * @return the graph and the ingestion speed
+     */
+    static pair<CSR_Graph, Ingest_Stats> stream_graphml(const string &filename, int threads, const string &weight_attr="distance",
+                                                        Dist_T default_weight=1.0, bool verbose=false, size_t block_size=STREAM_BLOCK_SIZE) {
+        auto start = chrono::steady_clock::now();
+        Thread_Pool pool(threads);
+        vector<Edge_List> chunks;
+        unordered_map<string, Node_id_T> ids;
+        GraphML_Weight_Key key;
+        bool header_done = false;
+
+        stream_blocks(filename, block_size, graphml_complete_until, [&](const string &text, size_t end) {
+            if (!header_done) {
+                key = parse_graphml_weight_key(text, graphml_next_element(text, 0, end), weight_attr, default_weight);
+                header_done = true;
+            }
+
+            auto cuts = split_at_records(text, end, pool.size(), graphml_next_element);
+            vector<GraphML_Piece> pieces(pool.size());
+            pool.run([&](int i) {
+                parse_graphml_piece(text, cuts[i], cuts[i+1], key, pieces[i]);
+            });
+
+            // the only serial step: numbering the names in document order
+            vector<vector<Node_id_T>> global_ids(pieces.size());
+            for (size_t i = 0; i < pieces.size(); i++) {
+                for (const string &name : pieces[i].names) {
+                    global_ids[i].push_back(ids.emplace(name, static_cast<Node_id_T>(ids.size())).first->second);
+                }
+            }
+            pool.run([&](int i) {
+                Edge_List &edges = pieces[i].edges;
+                for (int64_t e = 0; e < edges.size(); e++) {
+                    edges.sources[e] = global_ids[i][edges.sources[e]];
+                    edges.targets[e] = global_ids[i][edges.targets[e]];
+                }
+                edges.nodes_count = 0;
+            });
+            for (auto &piece : pieces) {
+                chunks.push_back(move(piece.edges));
+            }
+        });
+
+        return finish_stream(filename, chunks, static_cast<int64_t>(ids.size()), true, start, verbose);
+    }
+
+    /**
+     * Writes g as a binary snapshot that load_csr_snapshot maps back without parsing
+     */
+    static void write_csr_snapshot(const string &filename, const CSR_Graph &g) {
+        ofstream file(filename, ios::binary);
+        if (!file) {
+            throw runtime_error("Cannot open file: " + filename);
+        }
+
+        CSR_Snapshot_Header header{};
+        memcpy(header.magic, CSR_SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = CSR_SNAPSHOT_VERSION;
+        header.flags = g.has_integer_weights() ? CSR_SNAPSHOT_INTEGER_WEIGHTS : 0;
+        header.nodes_count = g.num_vertices();
+        header.edges_count = g.num_edges();
+        header.max_weight = g.max_weight();
+        CSR_Snapshot_Layout layout(header.nodes_count, header.edges_count);
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(g.offsets_data()), layout.targets_pos - layout.offsets_pos);
+        file.write(reinterpret_cast<const char*>(g.targets_data()), header.edges_count * sizeof(Node_id_T));
+        const char padding[sizeof(Dist_T)] = {};
+        file.write(padding, layout.weights_pos - layout.targets_pos - header.edges_count * sizeof(Node_id_T));
+        file.write(reinterpret_cast<const char*>(g.weights_data()), layout.size - layout.weights_pos);
+
+        if (!file) {
+            throw runtime_error("Error writing snapshot: " + filename);
+        }
+    }
+
+    /**
+     * Maps a snapshot written by write_csr_snapshot read-only, the graph is a view over the mapping which is released
+     * with the last copy of the graph. The pages are loaded on first access.
+     */
+    static CSR_Graph load_csr_snapshot(const string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open file: " + filename);
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CSR_Snapshot_Header)) {
+            close(fd);
+            throw runtime_error("Not a CSR snapshot: " + filename);
+        }
+        const size_t size = st.st_size;
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            throw runtime_error("Cannot map file: " + filename);
+        }
+        shared_ptr<const void> mapping(addr, [size](const void *p) {
+            munmap(const_cast<void*>(p), size);
+        });
+
+        const auto *header = static_cast<const CSR_Snapshot_Header*>(addr);
+        if (memcmp(header->magic, CSR_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || header->version != CSR_SNAPSHOT_VERSION) {
+            throw runtime_error("Not a CSR snapshot: " + filename);
+        }
+        CSR_Snapshot_Layout layout(header->nodes_count, header->edges_count);
+        if (layout.size != size) {
+            throw runtime_error("Truncated CSR snapshot: " + filename);
+        }
+
+        const char *base = static_cast<const char*>(addr);
+        return CSR_Graph(mapping, header->nodes_count, header->edges_count,
+                         reinterpret_cast<const CSR_Graph::Edge_id_T*>(base + layout.offsets_pos),
+                         reinterpret_cast<const Node_id_T*>(base + layout.targets_pos),
+                         reinterpret_cast<const Dist_T*>(base + layout.weights_pos),
+                         (header->flags & CSR_SNAPSHOT_INTEGER_WEIGHTS) != 0, header->max_weight);
+    }
+
+    /**
+     * One-time conversion of a BGP GraphML file (both directions of every edge) to a snapshot
+     */
+    static void convert_bgp_graphml_to_csr_snapshot(const string &graphml, const string &snapshot, bool verbose=true) {
+        write_csr_snapshot(snapshot, CSR_Graph(read_bgp_graphml(graphml, verbose).first));
+        if (verbose) cout << "Snapshot written: " << snapshot << endl;
+    }
+
+    // snapshot sitting next to a GraphML file, e.g. data/x.graphml -> data/x.csr
+    static string csr_snapshot_path(const string &graphml) {
+        size_t dot = graphml.rfind(".graphml");
+        return (dot == string::npos ? graphml : graphml.substr(0, dot)) + ".csr";
+    }
+
+    static bool file_exists(const string &filename) {
+        struct stat st{};
+        return stat(filename.c_str(), &st) == 0;
+    }
+
+    static pair<CSR_Graph, Ingest_Stats> finish_stream(const string &filename, const vector<Edge_List> &chunks, int64_t nodes_count,
+                                                       bool both_directions, chrono::steady_clock::time_point start, bool verbose) {
+        CSR_Graph g(chunks, nodes_count, both_directions);
+        Ingest_Stats stats;
+        stats.nodes_count = g.num_vertices();
+        for (const auto &chunk : chunks) {
+            stats.edges_count += chunk.size();
+        }
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (verbose) {
+            cout << "Read " << stats.edges_count << " edges and " << stats.nodes_count << " nodes from " << filename
+                 << " in " << stats.seconds * 1000 << " ms (" << stats.edges_per_second() << " edges/s)" << endl;
+        }
+        return {g, stats};
+    }
+
     static void export_to_dot(const string &filename, const Graph& g) {
         ofstream file(filename);
         boost::write_graphviz(file, g, boost::default_writer(), boost::make_label_writer(boost::get(boost::edge_weight, g)));
@@ -2,12 +2,18 @@
 #define GRAPH_UTILS_HPP
 
 #include <random>
+#include <cassert>
+#include <atomic>
+#include <limits>
 #include <regex>
 #include <unordered_set>
 #include <unordered_map>
+#include <thread>
 
 #include "../common.hpp"
+#include "../csr_graph.hpp"
 #include "file_utils.hpp"
+#include "thread_pool.hpp"
 
 using namespace std;
 
@@ -15,7 +21,7 @@ inline uint64_t encode_edge(int u, int v) {
     return uint64_t(u) << 32 | uint64_t(v);
 }
 
-Graph random_barabasi_albert(int m0, int m, int64_t t, int max_weight, int seed) {
+Edge_List random_barabasi_albert_edges(int m0, int m, int64_t t, int max_weight, int seed) {
     if (m > m0) {
         throw invalid_argument("Number of edges per new node cannot be greater than initial number of nodes.");
     }
@@ -26,7 +32,7 @@ Graph random_barabasi_albert(int m0, int m, int64_t t, int max_weight, int seed)
 
     int64_t N = m0+t;
     int64_t M = 2*m*t + m0*(m0-1);
-    Graph G(N);
+    Edge_List G(N); G.reserve(M);
     vector<Node_id_T> repeated_nodes; repeated_nodes.reserve(M);
     mt19937_64 rng(seed);
     uniform_real_distribution<> weight_dist(1, max_weight);
@@ -34,8 +40,8 @@ Graph random_barabasi_albert(int m0, int m, int64_t t, int max_weight, int seed)
     for (int i = 0; i < m0; i++) {
         for (int j = i+1; j < m0; j++) {
             Dist_T w = weight_dist(rng);
-            boost::add_edge(i, j, w, G);
-            boost::add_edge(j, i, w, G);
+            G.add_edge(i, j, w);
+            G.add_edge(j, i, w);
 
             repeated_nodes.push_back(i);
             repeated_nodes.push_back(j);
@@ -55,8 +61,8 @@ Graph random_barabasi_albert(int m0, int m, int64_t t, int max_weight, int seed)
 
             if (v != u && chosen.insert(v).second) {
                 Dist_T w = weight_dist(rng);
-                boost::add_edge(u, v, w, G);
-                boost::add_edge(v, u, w, G);
+                G.add_edge(u, v, w);
+                G.add_edge(v, u, w);
 
                 repeated_nodes.push_back(u);
                 repeated_nodes.push_back(v);
@@ -67,150 +73,281 @@ Graph random_barabasi_albert(int m0, int m, int64_t t, int max_weight, int seed)
     return G;
 }
 
+Graph random_barabasi_albert(int m0, int m, int64_t t, int max_weight, int seed) {
+    return random_barabasi_albert_edges(m0, m, t, max_weight, seed).to_graph();
+}
+
+Edge_List random_graph_edges(int64_t N, int max_weight, int seed) {
+    return random_barabasi_albert_edges(1, 1, N-1, max_weight, seed);
+}
+
 Graph random_graph(int64_t N, int max_weight, int seed) {
-    return random_barabasi_albert(1, 1, N-1, max_weight, seed);
+    return random_graph_edges(N, max_weight, seed).to_graph();
+}
+
+Edge_List random_graph_with_unit_weights_edges(int64_t N, int seed) {
+    return random_barabasi_albert_edges(1, 1, N-1, 1, seed);
 }
 
 Graph random_graph_with_unit_weights(int64_t N, int seed) {
-    return random_barabasi_albert(1, 1, N-1, 1, seed);
+    return random_graph_with_unit_weights_edges(N, seed).to_graph();
 }
 
-Graph grid_graph(int w, int h) {
+Edge_List grid_graph_edges(int w, int h) {
     if (w <= 1 || h <= 1) {
         throw invalid_argument("Minimum grid is a 2x2");
     }
 
-    Graph G(w*h);
+    Edge_List G(w*h); G.reserve(4*static_cast<int64_t>(w)*h);
     for (int i = 0; i < w; i++) {
         for (int j = 0; j < h; j++) {
             Node_id_T id = i*h+j;
             if (j > 0) {
-                boost::add_edge(id-1, id, 1, G);
-                boost::add_edge(id, id-1, 1, G);
+                G.add_edge(id-1, id, 1);
+                G.add_edge(id, id-1, 1);
             }
             if (i > 0) {
-                boost::add_edge(id-h, id, 1, G);
-                boost::add_edge(id, id-h, 1, G);
+                G.add_edge(id-h, id, 1);
+                G.add_edge(id, id-h, 1);
             }
         }
     }
     return G;
 }
 
-pair<Graph, int> constant_degree_transformation(Graph G, int N) {
-    Graph G_prime;
-    unordered_map<Node_id_T, string> id_to_name;
-    unordered_map<string, Node_id_T> name_to_id;
-    int nextId = N-1;
-
-    unordered_map<Node_id_T, vector<Node_id_T>> outgoings;
-    unordered_map<Node_id_T, vector<Node_id_T>> incomings;
-    for (int i = 0; i < N; i++) {
-        auto oe = boost::out_edges(i, G);
-        auto ei = oe.first; auto ei_end = oe.second;
-        for (; ei != ei_end; ++ei) {
-            outgoings[i].push_back(boost::target(*ei, G));
-        }
-        for (Node_id_T nei: outgoings[i]) {
-            incomings[nei].push_back(i);
+Graph grid_graph(int w, int h) {
+    return grid_graph_edges(w, h).to_graph();
+}
+
+/**
+ * Result of constant_degree_transformation: every vertex v of the input with more than 3 edges, or more than 2 in or
+ * out edges, becomes a cycle of 0 weight edges with one vertex per edge: first the out-edges, then the in-edges.
+ * v keeps the first vertex of its cycle, so the original vertices keep their ids.
+ */
+struct Constant_Degree_Graph {
+    CSR_Graph graph;
+    vector<Node_id_T> first_gadget; // input vertices + 1 entries, the cycle of v is v then [first_gadget[v], first_gadget[v+1])
+    vector<Node_id_T> original_of; // input vertex of every vertex of graph
+
+    // vertex of the cycle of v standing for its k-th edge, out-edges first
+    Node_id_T cycle_vertex(Node_id_T v, int k) const {
+        return k == 0 ? v : first_gadget[v] + k - 1;
+    }
+};
+
+/**
+ * The gadget ids come from prefix sums of the degrees, so the output adjacency is written in one pass, split by vertex
+ * between the threads
+ */
+Constant_Degree_Graph constant_degree_transformation(const CSR_Graph &G, int threads = 1) {
+    using Edge_id_T = CSR_Graph::Edge_id_T;
+    const Node_id_T N = G.num_vertices();
+
+    // rank of every edge among the in-edges of its target, in order of source then out-edge
+    vector<int> in_degree(N, 0);
+    vector<int> in_rank(G.num_edges());
+    for (Edge_id_T e = 0; e < G.num_edges(); e++) {
+        in_rank[e] = in_degree[G.target(e)]++;
+    }
+
+    Constant_Degree_Graph cd;
+    cd.first_gadget.assign(N+1, 0);
+    vector<uint8_t> gadget(N, 0);
+    Node_id_T next_id = N;
+    for (Node_id_T v = 0; v < N; v++) {
+        const int out = G.out_degree(v), in = in_degree[v];
+        gadget[v] = out + in > 3 || in > 2 || out > 2;
+        cd.first_gadget[v] = next_id;
+        next_id += gadget[v] ? out + in - 1 : 0;
+    }
+    cd.first_gadget[N] = next_id;
+
+    // an original edge u->v lands on the in-edge vertex of its rank in the cycle of v
+    auto head = [&](Edge_id_T e) {
+        const Node_id_T v = G.target(e);
+        return gadget[v] ? cd.cycle_vertex(v, G.out_degree(v) + in_rank[e]) : v;
+    };
+
+    Thread_Pool pool(threads);
+    const int T = pool.size();
+    vector<Edge_id_T> offsets(next_id + 1, 0);
+    cd.original_of.resize(next_id);
+    pool.run([&](int w) {
+        for (Node_id_T v = static_cast<int64_t>(N) * w / T; v < static_cast<int64_t>(N) * (w+1) / T; v++) {
+            const int out = G.out_degree(v);
+            if (!gadget[v]) {
+                offsets[v+1] = out;
+                cd.original_of[v] = v;
+                continue;
+            }
+            for (int k = 0; k < out + in_degree[v]; k++) {
+                Node_id_T x = cd.cycle_vertex(v, k);
+                offsets[x+1] = k < out ? 2 : 1;
+                cd.original_of[x] = v;
+            }
         }
+    });
+    for (Node_id_T x = 0; x < next_id; x++) {
+        offsets[x+1] += offsets[x];
     }
 
-    for (int i = 0; i < N; i++) {
-        int out_size = static_cast<int>(outgoings[i].size());
-        int in_size = static_cast<int>(incomings[i].size());
-
-        vector<Node_id_T> cycle_nodes;
-        if (out_size + in_size > 3 || in_size > 2 || out_size > 2) {
-
-            bool is_first_of_cycle = true;
-
-            for (Node_id_T desti : outgoings[i]) {
-                string new_node = "x_"+to_string(i)+"_"+to_string(desti);
-                if (is_first_of_cycle) {
-                    is_first_of_cycle = false;
-                    name_to_id[new_node] = i;
-                    id_to_name[i] = new_node;
-                    cycle_nodes.push_back(i);
-                }else {
-                    nextId++;
-                    name_to_id[new_node] = nextId;
-                    id_to_name[nextId] = new_node;
-                    cycle_nodes.push_back(nextId);
+    vector<Node_id_T> targets(offsets[next_id]);
+    vector<Dist_T> weights(offsets[next_id]);
+    pool.run([&](int w) {
+        for (Node_id_T v = static_cast<int64_t>(N) * w / T; v < static_cast<int64_t>(N) * (w+1) / T; v++) {
+            const int out = G.out_degree(v);
+            if (!gadget[v]) {
+                for (Edge_id_T e = G.edges_begin(v), pos = offsets[v]; e < G.edges_end(v); e++, pos++) {
+                    targets[pos] = head(e);
+                    weights[pos] = G.weight(e);
                 }
-
+                continue;
             }
-            for (Node_id_T source : incomings[i]) {
-                string new_node = "y_"+to_string(source)+"_"+to_string(i);
-                if (is_first_of_cycle) {
-                    is_first_of_cycle = false;
-                    name_to_id[new_node] = i;
-                    id_to_name[i] = new_node;
-                    cycle_nodes.push_back(i);
-                }else {
-                    nextId++;
-                    name_to_id[new_node] = nextId;
-                    id_to_name[nextId] = new_node;
-                    cycle_nodes.push_back(nextId);
+            const int cycle_size = out + in_degree[v];
+            for (int k = 0; k < cycle_size; k++) {
+                Edge_id_T pos = offsets[cd.cycle_vertex(v, k)];
+                targets[pos] = cd.cycle_vertex(v, (k+1) % cycle_size);
+                weights[pos] = 0;
+                if (k < out) {
+                    targets[pos+1] = head(G.edges_begin(v) + k);
+                    weights[pos+1] = G.weight(G.edges_begin(v) + k);
                 }
             }
+        }
+    });
 
-            int cycle_size = static_cast<int>(cycle_nodes.size());
-            for (int j = 0; j < cycle_size; j++) {
-                boost::add_edge(cycle_nodes[j], cycle_nodes[(j+1)%cycle_size], 0, G_prime);
-            }
+    cd.graph = CSR_Graph(move(offsets), move(targets), move(weights));
+    return cd;
+}
+
+/**
+ * Boost version of the above
+ * @param N number of vertices of G
+ * @return the transformed graph and its number of vertices
+ */
+pair<Graph, int> constant_degree_transformation(const Graph &G, int N) {
+    if (static_cast<int>(boost::num_vertices(G)) != N) {
+        throw invalid_argument("N must be the number of vertices of G");
+    }
+    auto cd = constant_degree_transformation(CSR_Graph(G));
+    return {cd.graph.to_graph(), cd.graph.num_vertices()};
+}
+
+/**
+ * Uniform grid over the (angle, height) coordinates of points on a cylinder, the k-NN queries visit the cells in rings
+ * around the query until no closer point can remain
+ */
+struct Cylinder_Grid {
+    int columns = 1; // along the angle, wrapping around
+    int rows = 1; // along the height
+    double radius, height;
+    vector<uint64_t> cell_start; // points of cell c are cell_points[cell_start[c], cell_start[c+1])
+    vector<uint64_t> cell_points;
+    vector<int> column_of, row_of;
+
+    Cylinder_Grid(const vector<double> &angles, const vector<double> &zs, double radius, double height) : radius(radius), height(height) {
+        const uint64_t N = angles.size();
+        const double cells = max<double>(1, N / 2.0); // about 2 points per cell
+        const double circumference = 2*M_PI*radius;
+        if (circumference > 0 && height > 0) {
+            double side = sqrt(circumference * height / cells);
+            columns = static_cast<int>(max(1.0, min(cells, round(circumference / side))));
+            rows = static_cast<int>(max(1.0, min(cells, round(height / side))));
+        } else if (circumference > 0) {
+            columns = static_cast<int>(cells);
+        } else if (height > 0) {
+            rows = static_cast<int>(cells);
         }
+
+        column_of.resize(N);
+        row_of.resize(N);
+        cell_start.assign(static_cast<size_t>(columns) * rows + 1, 0);
+        for (uint64_t i = 0; i < N; i++) {
+            column_of[i] = min(columns-1, static_cast<int>(angles[i] / (2*M_PI) * columns));
+            row_of[i] = height > 0 ? min(rows-1, max(0, static_cast<int>((zs[i] + height/2) / height * rows))) : 0;
+            cell_start[cell(column_of[i], row_of[i]) + 1]++;
+        }
+        for (size_t c = 1; c < cell_start.size(); c++) {
+            cell_start[c] += cell_start[c-1];
+        }
+        cell_points.resize(N);
+        vector<uint64_t> next(cell_start.begin(), cell_start.end()-1);
+        for (uint64_t i = 0; i < N; i++) {
+            cell_points[next[cell(column_of[i], row_of[i])]++] = i;
+        }
+    }
+
+    size_t cell(int column, int row) const {
+        return static_cast<size_t>(row) * columns + column;
     }
 
-    for (int i = 0; i <= nextId; i++) {
-        if (i >= N || id_to_name.find(i) != id_to_name.end()) {
-            string u = id_to_name[i];
+    // smallest distance between point i and any point ring+1 or more cells away from its cell
+    double lower_bound_beyond(uint64_t i, int ring) const {
+        double bound = numeric_limits<double>::infinity();
+        if (ring + 1 <= columns / 2) {
+            bound = min(bound, 2*radius*sin(min(M_PI, ring * 2*M_PI / columns) / 2));
+        }
+        if (ring + 1 <= max(row_of[i], rows-1-row_of[i])) {
+            bound = min(bound, ring * height / rows);
+        }
+        return bound * (1 - 1e-9);
+    }
 
-            if (u.find("y_") != string::npos) {
-                continue;
+    /**
+     * Calls visit(j) for every point of the cells at ring distance exactly ring from the cell of point i
+     * @return false once the ring is past every cell
+     */
+    template<typename Visit>
+    bool visit_ring(uint64_t i, int ring, Visit visit) const {
+        const int c = column_of[i], r = row_of[i];
+        const int max_column_ring = columns / 2, max_row_ring = max(r, rows-1-r);
+        if (ring > max_column_ring && ring > max_row_ring) {
+            return false;
+        }
+        auto visit_column = [&](int dc, int row) {
+            if (row < 0 || row >= rows) {
+                return;
             }
-            string A_to_B = u.substr(u.find("_")+1);
-            Node_id_T A = stoi(A_to_B.substr(0, A_to_B.find("_")));
-            Node_id_T B = stoi(A_to_B.substr(A_to_B.find("_")+1));
-            string dest = "y_"+A_to_B;
-
-            auto old_edge = boost::edge(A, B, G);
-            if (!old_edge.second) {
-                continue;
+            int col = ((c + dc) % columns + columns) % columns;
+            for (uint64_t p = cell_start[cell(col, row)]; p < cell_start[cell(col, row) + 1]; p++) {
+                visit(cell_points[p]);
             }
-            Dist_T weight = boost::get(boost::edge_weight, G, old_edge.first);
-
-            if (name_to_id.find(dest) != name_to_id.end()) {
-                boost::add_edge(i, name_to_id[dest], weight, G_prime);
-            }else {
-                boost::add_edge(i, B, weight, G_prime);
+        };
+        auto visit_columns_at = [&](int d, int row) { // the columns d apart from c, counted once
+            if (d > max_column_ring) {
+                return;
             }
-        }else {
-            auto oe = boost::out_edges(i, G);
-            auto ei = oe.first; auto ei_end = oe.second;
-            for (; ei != ei_end; ++ei) {
-                Node_id_T j = boost::target(*ei, G);
-                Dist_T weight = boost::get(boost::edge_weight, G, *ei);
-                if (id_to_name.find(j) != id_to_name.end()) {
-                    boost::add_edge(i, name_to_id["y_"+to_string(i)+"_"+to_string(j)], weight, G_prime);
-                }else {
-                    boost::add_edge(i, j, weight, G_prime);
-                }
+            visit_column(d, row);
+            if (d != 0 && 2*d != columns) {
+                visit_column(-d, row);
             }
+        };
+
+        for (int dr = -ring; dr <= ring; dr++) {
+            visit_columns_at(ring, r + dr);
+        }
+        for (int d = 0; d < ring; d++) {
+            visit_columns_at(d, r - ring);
+            visit_columns_at(d, r + ring);
         }
+        return true;
     }
+};
 
-    return {G_prime, nextId+1};
-}
-
-Graph cylinder_knn_graph(const uint64_t N, double radius, double height, int k, int seed) {
-    Graph G(N);
+/**
+ * Points uniformly drawn on a cylinder, every point is linked to its k nearest neighbors (ties broken by index)
+ * @param threads workers answering the k-NN queries, the edges don't depend on it
+ */
+Edge_List cylinder_knn_graph_edges(const uint64_t N, double radius, double height, int k, int seed, int threads = 1) {
+    Edge_List G(N); G.reserve(N*k);
     using Point = tuple<double, double, double>;
     auto euclidian_dist = [](const Point& p1, const Point& p2) {
         return sqrt(pow(get<0>(p1)-get<0>(p2), 2) + pow(get<1>(p1)-get<1>(p2), 2) + pow(get<2>(p1)-get<2>(p2), 2));
     };
 
     vector<Point> points; points.reserve(N);
+    vector<double> angles; angles.reserve(N);
+    vector<double> zs; zs.reserve(N);
     mt19937 rng(seed);
     uniform_real_distribution<> angle_dist(0.0, 2*M_PI);
     uniform_real_distribution<> z_dist(-1*height/2, height/2);
@@ -221,24 +358,59 @@ Graph cylinder_knn_graph(const uint64_t N, double radius, double height, int k,
         double x = radius*cos(phi);
         double y = radius*sin(phi);
         points.emplace_back(x, y, z);
+        angles.push_back(phi);
+        zs.push_back(z);
     }
 
-    for (uint64_t i = 0; i < N; i++) {
-        vector<pair<double, uint64_t>> dists; dists.reserve(N);
-        for (uint64_t j = 0; j < N; j++) {
-            dists.emplace_back(euclidian_dist(points[i], points[j]), j);
+    // the k+1 smallest (distance, j) including i itself, then i is skipped
+    const uint64_t K = min<uint64_t>(k+1, N);
+    const Cylinder_Grid grid(angles, zs, radius, height);
+    vector<pair<double, uint64_t>> nearest(N * K);
+    Thread_Pool pool(threads);
+    atomic<uint64_t> next_query{0};
+    pool.run([&](int) {
+        vector<pair<double, uint64_t>> heap; heap.reserve(K+1);
+        const uint64_t CHUNK = 256;
+        for (uint64_t begin = next_query.fetch_add(CHUNK); begin < N; begin = next_query.fetch_add(CHUNK)) {
+            for (uint64_t i = begin; i < min(N, begin + CHUNK); i++) {
+                heap.clear();
+                auto visit = [&](uint64_t j) {
+                    pair<double, uint64_t> candidate(euclidian_dist(points[i], points[j]), j);
+                    if (heap.size() < K) {
+                        heap.push_back(candidate);
+                        push_heap(heap.begin(), heap.end());
+                    } else if (candidate < heap.front()) {
+                        pop_heap(heap.begin(), heap.end());
+                        heap.back() = candidate;
+                        push_heap(heap.begin(), heap.end());
+                    }
+                };
+                for (int ring = 0; grid.visit_ring(i, ring, visit); ring++) {
+                    if (heap.size() == K && heap.front().first < grid.lower_bound_beyond(i, ring)) {
+                        break;
+                    }
+                }
+                sort_heap(heap.begin(), heap.end());
+                copy(heap.begin(), heap.end(), nearest.begin() + i*K);
+            }
         }
-        nth_element(dists.begin(), dists.begin()+k+1, dists.end());
-        for (uint64_t j = 0; j < k+1; j++) {
-            if (i == dists[j].second) {
+    });
+
+    for (uint64_t i = 0; i < N; i++) {
+        for (uint64_t j = 0; j < K; j++) {
+            const auto &p = nearest[i*K + j];
+            if (i == p.second) {
                 continue;
             }
-            boost::add_edge(i, dists[j].second, dists[j].first, G);
+            G.add_edge(i, p.second, p.first);
         }
     }
 
     return G;
 }
+Graph cylinder_knn_graph(const uint64_t N, double radius, double height, int k, int seed) {
+    return cylinder_knn_graph_edges(N, radius, height, k, seed).to_graph();
+}
 
 inline unordered_map<string, int64_t> extract_params(const string& input) {
     unordered_map<string, int64_t> params;
@@ -254,31 +426,63 @@ inline unordered_map<string, int64_t> extract_params(const string& input) {
     return params;
 }
 
+/**
+ * Generates the edges of a graph based on the specifications
+ * @param specifications instructions to generate a graph, see go_get_that_graph
+ * @return the generated edges
+ */
+Edge_List go_get_those_edges(const string& specifications) {
+    unordered_map<string, int64_t> params = extract_params(specifications);
+    if (specifications.find("random unweighted") != string::npos) {
+        return random_graph_with_unit_weights_edges(params["nodes_count"], static_cast<int>(params["seed"]));
+    }
+    if (specifications.find("random") != string::npos) {
+        return random_graph_edges(params["nodes_count"], static_cast<int>(params["max_weight"]), static_cast<int>(params["seed"]));
+    }
+    if (specifications.find("grid") != string::npos) {
+        return grid_graph_edges(static_cast<int>(params["w"]), static_cast<int>(params["h"]));
+    }
+    if (specifications.find("metric cylinder") != string::npos) {
+        return cylinder_knn_graph_edges(params["nodes_count"], static_cast<double>(params["r"]), static_cast<double>(params["h"]), static_cast<int>(params["k"]), static_cast<int>(params["seed"]),
+                                         max(1u, thread::hardware_concurrency()));
+    }
+    throw invalid_argument("Unknown graph specifications: " + specifications);
+}
+
 /**
  * This function either generates a graph or loads one located in file base the specifications
- * @param specifications a graphml filepath or instructions to generate a graph
+ * @param specifications a .csr snapshot or graphml filepath or instructions to generate a graph
  * @return a Graph
  */
 Graph go_get_that_graph(const string& specifications) {
-    unordered_map<string, int64_t> params;
-
     try {
+        if (specifications.find(".csr") != string::npos) {
+            return FileUtils::load_csr_snapshot(specifications).to_graph();
+        }
         if (specifications.find(".graphml") != string::npos) {
             return FileUtils::read_graphml<BGP_Info>(specifications, false).first;
         }
-        params = extract_params(specifications);
-        if (specifications.find("random unweighted") != string::npos) {
-            return random_graph_with_unit_weights(params["nodes_count"], static_cast<int>(params["seed"]));
-        }
-        if (specifications.find("random") != string::npos) {
-            return random_graph(params["nodes_count"], static_cast<int>(params["max_weight"]), static_cast<int>(params["seed"]));
-        }
-        if (specifications.find("grid") != string::npos) {
-            return grid_graph(static_cast<int>(params["w"]), static_cast<int>(params["h"]));
+        return go_get_those_edges(specifications).to_graph();
+    } catch (exception& e) {
+        throw invalid_argument("Couldn't find a graph based on your specifications check the API of go_get_that_graph. This error happened:\n" + string(e.what()));
+    }
+}
+
+/**
+ * Same as go_get_that_graph but the generators build the CSR graph directly and snapshots are memory mapped
+ * @param specifications a .csr snapshot or graphml filepath or instructions to generate a graph
+ * @return a CSR_Graph
+ */
+CSR_Graph go_get_that_csr_graph(const string& specifications) {
+    try {
+        if (specifications.find(".csr") != string::npos) {
+            return FileUtils::load_csr_snapshot(specifications);
         }
-        if (specifications.find("metric cylinder") != string::npos) {
-            return cylinder_knn_graph(params["nodes_count"], static_cast<double>(params["r"]), static_cast<double>(params["h"]), static_cast<int>(params["k"]), static_cast<int>(params["seed"]));
+        if (specifications.find(".graphml") != string::npos) {
+            int threads = max(1u, thread::hardware_concurrency());
+            return FileUtils::stream_graphml(specifications, threads).first;
         }
+        return CSR_Graph(go_get_those_edges(specifications));
     } catch (exception& e) {
         throw invalid_argument("Couldn't find a graph based on your specifications check the API of go_get_that_graph. This error happened:\n" + string(e.what()));
     }
@@ -0,0 +1,90 @@
+#ifndef OP_COUNTERS_HPP
+#define OP_COUNTERS_HPP
+
+#include <cstdint>
+#include <algorithm>
+
+/*
+ * Event counters of the BMSSP and BBL_DS hot paths, compiled in with -DBMSSP_COUNTERS (cmake -DBMSSP_COUNTERS=ON).
+ * Without it the COUNT_OP* macros expand to nothing. The counters belong to the calling thread, the pool workers of the
+ * parallel find_pivots don't count: their edges are counted by the caller.
+ */
+
+using namespace std;
+
+struct Op_Counters {
+    uint64_t bmssp_calls = 0;
+    uint64_t recursion_depth = 0; // current nesting of BMSSP calls
+    uint64_t max_recursion_depth = 0;
+    uint64_t find_pivots_calls = 0;
+    uint64_t pivots = 0;
+    uint64_t pivot_relaxations = 0; // edges scanned by find_pivots
+    uint64_t base_case_calls = 0;
+    uint64_t hybrid_calls = 0; // calls below BMSSP_Params::hybrid_cutoff
+    uint64_t base_case_relaxations = 0; // edges scanned by the base cases and the hybrid Dijkstras
+    uint64_t bmssp_relaxations = 0; // edges scanned from the vertices completed by the recursions
+    uint64_t ds_inserts = 0;
+    uint64_t ds_splits = 0;
+    uint64_t ds_batch_prepends = 0;
+    uint64_t ds_prepended_pairs = 0;
+    uint64_t max_D0_blocks = 0;
+    uint64_t ds_pulls = 0;
+    uint64_t ds_pull_buffer_pairs = 0; // sum of the pull buffer sizes
+    uint64_t max_pull_buffer = 0;
+
+    void reset() {
+        *this = Op_Counters();
+    }
+
+    // calls f(name, value) for every counter
+    template<typename F>
+    void for_each(F f) const {
+        f("bmssp_calls", bmssp_calls);
+        f("max_recursion_depth", max_recursion_depth);
+        f("find_pivots_calls", find_pivots_calls);
+        f("pivots", pivots);
+        f("pivot_relaxations", pivot_relaxations);
+        f("base_case_calls", base_case_calls);
+        f("hybrid_calls", hybrid_calls);
+        f("base_case_relaxations", base_case_relaxations);
+        f("bmssp_relaxations", bmssp_relaxations);
+        f("ds_inserts", ds_inserts);
+        f("ds_splits", ds_splits);
+        f("ds_batch_prepends", ds_batch_prepends);
+        f("ds_prepended_pairs", ds_prepended_pairs);
+        f("max_D0_blocks", max_D0_blocks);
+        f("ds_pulls", ds_pulls);
+        f("ds_pull_buffer_pairs", ds_pull_buffer_pairs);
+        f("max_pull_buffer", max_pull_buffer);
+    }
+};
+
+inline Op_Counters &op_counters() {
+    static thread_local Op_Counters counters;
+    return counters;
+}
+
+// counts one level of BMSSP recursion for its lifetime
+struct Op_Depth_Guard {
+    Op_Depth_Guard() {
+        Op_Counters &c = op_counters();
+        c.max_recursion_depth = max(c.max_recursion_depth, ++c.recursion_depth);
+    }
+    ~Op_Depth_Guard() {
+        op_counters().recursion_depth--;
+    }
+};
+
+#ifdef BMSSP_COUNTERS
+#define COUNT_OP(name) (++op_counters().name)
+#define COUNT_OP_N(name, n) (op_counters().name += static_cast<uint64_t>(n))
+#define COUNT_OP_MAX(name, v) (op_counters().name = max(op_counters().name, static_cast<uint64_t>(v)))
+#define COUNT_OP_DEPTH() Op_Depth_Guard op_depth_guard
+#else
+#define COUNT_OP(name) ((void)0)
+#define COUNT_OP_N(name, n) ((void)0)
+#define COUNT_OP_MAX(name, v) ((void)0)
+#define COUNT_OP_DEPTH() ((void)0)
+#endif
+
+#endif //OP_COUNTERS_HPP
@@ -0,0 +1,388 @@
+#ifndef RESULT_IO_HPP
+#define RESULT_IO_HPP
+
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../common.hpp"
+
+/*
+ * Binary files of SSSP results, for the results too big to be printed. A file holds the distances and the parents of
+ * one source in the native byte order. The distances can be quantized to float, and the parents delta-encoded: each
+ * parent is stored as the zigzag varint of parent - vertex, which takes one or two bytes when the parents are close to
+ * their children as in the grids and the renumbered graphs. The varints are cut in blocks of SSSP_RESULT_BLOCK vertices
+ * whose byte positions are indexed, so the reader still reaches any parent without decoding the whole array.
+ */
+
+using namespace std;
+
+/**
+ * Header of the result files. It is followed by the distances (double, or float with SSSP_RESULT_FLOAT_DISTANCES),
+ * zero padding to 8 bytes and the parents: int32 per vertex, or with SSSP_RESULT_DELTA_PARENTS the block positions
+ * (uint64, blocks+1) followed by the varints.
+ */
+struct SSSP_Result_Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int64_t nodes_count;
+    int64_t source;
+    int64_t parents_bytes;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(SSSP_Result_Header) == 64, "the result header is 64 bytes");
+
+constexpr char SSSP_RESULT_MAGIC[8] = {'B', 'M', 'S', 'S', 'P', 'R', 'E', 'S'};
+constexpr uint32_t SSSP_RESULT_VERSION = 1;
+constexpr uint32_t SSSP_RESULT_FLOAT_DISTANCES = 1; // flags bit, lossy above 2^24
+constexpr uint32_t SSSP_RESULT_DELTA_PARENTS = 2; // flags bit
+constexpr int64_t SSSP_RESULT_BLOCK = 64; // vertices per block of delta-encoded parents
+
+// byte positions of the arrays in a result file
+struct SSSP_Result_Layout {
+    size_t dist_pos;
+    size_t parents_pos;
+    size_t size;
+
+    SSSP_Result_Layout(int64_t nodes_count, uint32_t flags, int64_t parents_bytes) {
+        dist_pos = sizeof(SSSP_Result_Header);
+        parents_pos = dist_pos + nodes_count * ((flags & SSSP_RESULT_FLOAT_DISTANCES) ? sizeof(float) : sizeof(Dist_T));
+        parents_pos = (parents_pos + alignof(uint64_t) - 1) / alignof(uint64_t) * alignof(uint64_t);
+        size = parents_pos + parents_bytes;
+    }
+};
+
+/**
+ * Delta-encoded parents: positions of the blocks in bytes, the last one is the end of the varints
+ */
+struct Delta_Parents {
+    vector<uint64_t> blocks;
+    vector<uint8_t> bytes;
+
+    explicit Delta_Parents(const Prev_List_T &parent) {
+        const int64_t N = parent.size();
+        blocks.reserve((N + SSSP_RESULT_BLOCK - 1) / SSSP_RESULT_BLOCK + 1);
+        bytes.reserve(N);
+        for (int64_t v = 0; v < N; v++) {
+            if (v % SSSP_RESULT_BLOCK == 0) {
+                blocks.push_back(bytes.size());
+            }
+            const int64_t delta = static_cast<int64_t>(parent[v]) - v;
+            uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+            while (zigzag >= 0x80) {
+                bytes.push_back(static_cast<uint8_t>(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            bytes.push_back(static_cast<uint8_t>(zigzag));
+        }
+        blocks.push_back(bytes.size());
+    }
+
+    size_t size_in_bytes() const {
+        return blocks.size() * sizeof(uint64_t) + bytes.size();
+    }
+
+    /**
+     * Decodes the varint at p and moves p past it
+     * @return the parent of v
+     */
+    static Node_id_T decode(const uint8_t *&p, int64_t v) {
+        uint64_t zigzag = 0;
+        for (int shift = 0; ; shift += 7) {
+            const uint8_t byte = *p++;
+            zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                break;
+            }
+        }
+        const int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        return static_cast<Node_id_T>(v + delta);
+    }
+};
+
+/**
+ * Writes the distances and parents of source to filename
+ * @param flags SSSP_RESULT_FLOAT_DISTANCES and SSSP_RESULT_DELTA_PARENTS
+ */
+inline void write_sssp_result(const string &filename, Node_id_T source, const SSSP_Result &result, uint32_t flags = 0) {
+    const Dist_List_T &dist = result.first;
+    const Prev_List_T &parent = result.second;
+    if (dist.size() != parent.size()) {
+        throw invalid_argument("The distances and the parents of a result must have the same size");
+    }
+    ofstream file(filename, ios::binary);
+    if (!file) {
+        throw runtime_error("Cannot open file: " + filename);
+    }
+
+    SSSP_Result_Header header{};
+    memcpy(header.magic, SSSP_RESULT_MAGIC, sizeof(header.magic));
+    header.version = SSSP_RESULT_VERSION;
+    header.flags = flags & (SSSP_RESULT_FLOAT_DISTANCES | SSSP_RESULT_DELTA_PARENTS);
+    header.nodes_count = dist.size();
+    header.source = source;
+    unique_ptr<Delta_Parents> delta;
+    if (header.flags & SSSP_RESULT_DELTA_PARENTS) {
+        delta.reset(new Delta_Parents(parent));
+        header.parents_bytes = delta->size_in_bytes();
+    } else {
+        header.parents_bytes = parent.size() * sizeof(Node_id_T);
+    }
+    SSSP_Result_Layout layout(header.nodes_count, header.flags, header.parents_bytes);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t dist_bytes = dist.size() * sizeof(Dist_T);
+    if (header.flags & SSSP_RESULT_FLOAT_DISTANCES) {
+        vector<float> quantized(dist.size());
+        for (size_t i = 0; i < dist.size(); i++) {
+            // out of range doubles don't convert to float
+            quantized[i] = dist[i] >= numeric_limits<float>::max() ? numeric_limits<float>::infinity() : static_cast<float>(dist[i]);
+        }
+        dist_bytes = quantized.size() * sizeof(float);
+        file.write(reinterpret_cast<const char*>(quantized.data()), dist_bytes);
+    } else {
+        file.write(reinterpret_cast<const char*>(dist.data()), dist_bytes);
+    }
+    const char padding[sizeof(uint64_t)] = {};
+    file.write(padding, layout.parents_pos - layout.dist_pos - dist_bytes);
+    if (delta) {
+        file.write(reinterpret_cast<const char*>(delta->blocks.data()), delta->blocks.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(delta->bytes.data()), delta->bytes.size());
+    } else {
+        file.write(reinterpret_cast<const char*>(parent.data()), parent.size() * sizeof(Node_id_T));
+    }
+
+    if (!file) {
+        throw runtime_error("Error writing result: " + filename);
+    }
+}
+
+/**
+ * Read-only mapping of a file written by write_sssp_result, the pages are loaded on first access. Copies share the
+ * mapping, which is released with the last one.
+ */
+class SSSP_Result_File {
+public:
+    explicit SSSP_Result_File(const string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open file: " + filename);
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SSSP_Result_Header)) {
+            close(fd);
+            throw runtime_error("Not an SSSP result: " + filename);
+        }
+        const size_t size = st.st_size;
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            throw runtime_error("Cannot map file: " + filename);
+        }
+        mapping = shared_ptr<const void>(addr, [size](const void *p) {
+            munmap(const_cast<void*>(p), size);
+        });
+
+        header = static_cast<const SSSP_Result_Header*>(addr);
+        if (memcmp(header->magic, SSSP_RESULT_MAGIC, sizeof(header->magic)) != 0 || header->version != SSSP_RESULT_VERSION) {
+            throw runtime_error("Not an SSSP result: " + filename);
+        }
+        SSSP_Result_Layout layout(header->nodes_count, header->flags, header->parents_bytes);
+        if (layout.size != size) {
+            throw runtime_error("Truncated SSSP result: " + filename);
+        }
+        const char *base = static_cast<const char*>(addr);
+        dist_data = base + layout.dist_pos;
+        parents_data = base + layout.parents_pos;
+    }
+
+    int num_vertices() const {
+        return static_cast<int>(header->nodes_count);
+    }
+
+    Node_id_T source() const {
+        return static_cast<Node_id_T>(header->source);
+    }
+
+    uint32_t flags() const {
+        return header->flags;
+    }
+
+    Dist_T distance(Node_id_T v) const {
+        if (header->flags & SSSP_RESULT_FLOAT_DISTANCES) {
+            const float d = reinterpret_cast<const float*>(dist_data)[v];
+            return d == numeric_limits<float>::infinity() ? INF : static_cast<Dist_T>(d);
+        }
+        return reinterpret_cast<const Dist_T*>(dist_data)[v];
+    }
+
+    // decodes the block of v up to v with the delta-encoded parents
+    Node_id_T parent(Node_id_T v) const {
+        if (!(header->flags & SSSP_RESULT_DELTA_PARENTS)) {
+            return reinterpret_cast<const Node_id_T*>(parents_data)[v];
+        }
+        const int64_t block = v / SSSP_RESULT_BLOCK;
+        const uint8_t *p = varints() + block_positions()[block];
+        Node_id_T sortie = -1;
+        for (int64_t u = block * SSSP_RESULT_BLOCK; u <= v; u++) {
+            sortie = Delta_Parents::decode(p, u);
+        }
+        return sortie;
+    }
+
+    Dist_List_T distances() const {
+        Dist_List_T dist(num_vertices());
+        for (Node_id_T v = 0; v < num_vertices(); v++) {
+            dist[v] = distance(v);
+        }
+        return dist;
+    }
+
+    Prev_List_T parents() const {
+        if (!(header->flags & SSSP_RESULT_DELTA_PARENTS)) {
+            const Node_id_T *parent = reinterpret_cast<const Node_id_T*>(parents_data);
+            return Prev_List_T(parent, parent + num_vertices());
+        }
+        Prev_List_T parent(num_vertices());
+        const uint8_t *p = varints();
+        for (Node_id_T v = 0; v < num_vertices(); v++) {
+            parent[v] = Delta_Parents::decode(p, v);
+        }
+        return parent;
+    }
+
+    SSSP_Result result() const {
+        return {distances(), parents()};
+    }
+
+private:
+    shared_ptr<const void> mapping;
+    const SSSP_Result_Header *header;
+    const char *dist_data;
+    const char *parents_data;
+
+    const uint64_t *block_positions() const {
+        return reinterpret_cast<const uint64_t*>(parents_data);
+    }
+
+    const uint8_t *varints() const {
+        const int64_t blocks = (header->nodes_count + SSSP_RESULT_BLOCK - 1) / SSSP_RESULT_BLOCK;
+        return reinterpret_cast<const uint8_t*>(parents_data) + (blocks + 1) * sizeof(uint64_t);
+    }
+};
+
+/**
+ * Writes the results with write_sssp_result from a background thread, so the next query runs while the previous
+ * result is written. At most max_pending results wait in the queue, write() blocks beyond that to bound the memory.
+ * The first error of the background thread is rethrown by the next write() or wait().
+ */
+class SSSP_Result_Writer {
+public:
+    explicit SSSP_Result_Writer(uint32_t flags = 0, size_t max_pending = 2) :
+        flags(flags), max_pending(max(static_cast<size_t>(1), max_pending)), worker(&SSSP_Result_Writer::worker_loop, this) {
+    }
+
+    SSSP_Result_Writer(const SSSP_Result_Writer&) = delete;
+    SSSP_Result_Writer& operator=(const SSSP_Result_Writer&) = delete;
+
+    // writes the queued results, their errors are lost
+    ~SSSP_Result_Writer() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        job_cv.notify_all();
+        worker.join();
+    }
+
+    /**
+     * Queues result, pass it with move() to avoid the copy
+     */
+    void write(const string &filename, Node_id_T source, SSSP_Result result) {
+        unique_lock<mutex> lock(mtx);
+        done_cv.wait(lock, [this] { return jobs.size() < max_pending || error; });
+        rethrow_error();
+        jobs.push_back(Job{filename, source, move(result)});
+        lock.unlock();
+        job_cv.notify_one();
+    }
+
+    /**
+     * Blocks until every queued result is written
+     */
+    void wait() {
+        unique_lock<mutex> lock(mtx);
+        done_cv.wait(lock, [this] { return (jobs.empty() && !writing) || error; });
+        rethrow_error();
+    }
+
+private:
+    struct Job {
+        string filename;
+        Node_id_T source;
+        SSSP_Result result;
+    };
+
+    const uint32_t flags;
+    const size_t max_pending;
+    mutex mtx;
+    condition_variable job_cv, done_cv;
+    deque<Job> jobs;
+    bool writing = false;
+    bool stopping = false;
+    exception_ptr error = nullptr;
+    thread worker; // last, it starts once the rest is constructed
+
+    // called with mtx held
+    void rethrow_error() {
+        if (error) {
+            exception_ptr e = error;
+            error = nullptr;
+            rethrow_exception(e);
+        }
+    }
+
+    void worker_loop() {
+        unique_lock<mutex> lock(mtx);
+        while (true) {
+            job_cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) { // stopping
+                return;
+            }
+            Job job = move(jobs.front());
+            jobs.pop_front();
+            writing = true;
+            lock.unlock();
+            done_cv.notify_all(); // room in the queue
+
+            exception_ptr failure = nullptr;
+            try {
+                write_sssp_result(job.filename, job.source, job.result, flags);
+            } catch (...) {
+                failure = current_exception();
+            }
+
+            lock.lock();
+            writing = false;
+            if (failure && !error) {
+                error = failure;
+            }
+            done_cv.notify_all();
+        }
+    }
+};
+
+#endif //RESULT_IO_HPP
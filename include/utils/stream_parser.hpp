@@ -0,0 +1,271 @@
+#ifndef STREAM_PARSER_HPP
+#define STREAM_PARSER_HPP
+
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <limits>
+#include <chrono>
+#include <unordered_map>
+#include "../common.hpp"
+#include "../csr_graph.hpp"
+#include "thread_pool.hpp"
+
+/*
+ * Streaming readers behind FileUtils::stream_edge_list and FileUtils::stream_graphml: the file is read block by block,
+ * every block is cut at record boundaries and the pieces are parsed in parallel into edge chunks that CSR_Graph
+ * assembles directly, no intermediate graph is built.
+ */
+
+using namespace std;
+
+struct Ingest_Stats {
+    int64_t nodes_count = 0;
+    int64_t edges_count = 0; // edges in the file, before adding the reverse directions
+    double seconds = 0;
+
+    double edges_per_second() const {
+        return seconds > 0 ? edges_count / seconds : 0;
+    }
+};
+
+constexpr size_t STREAM_BLOCK_SIZE = 64 << 20;
+
+/**
+ * Reads filename block by block, parse_block(text, end) gets the complete records text[0, end) and the rest is kept
+ * in front of the next block
+ * @param complete_until end of the complete records of text, 0 when there is none yet
+ */
+template<typename Complete_Until, typename Parse_Block>
+void stream_blocks(const string &filename, size_t block_size, Complete_Until complete_until, Parse_Block parse_block) {
+    ifstream file(filename, ios::binary);
+    if (!file) {
+        throw runtime_error("Cannot open file: " + filename);
+    }
+
+    string text;
+    vector<char> buffer(block_size);
+    bool eof = false;
+    while (!eof) {
+        file.read(buffer.data(), block_size);
+        size_t got = file.gcount();
+        eof = got < block_size;
+        text.append(buffer.data(), got);
+
+        size_t end = eof ? text.size() : complete_until(text);
+        if (end > 0) {
+            parse_block(text, end);
+            text.erase(0, end);
+        }
+    }
+}
+
+/**
+ * Cuts text[0, end) in about n pieces, every cut is moved forward to a record start
+ * @param next_start first record start at or after pos, end if none
+ */
+template<typename Next_Start>
+vector<size_t> split_at_records(const string &text, size_t end, int n, Next_Start next_start) {
+    vector<size_t> cuts{0};
+    for (int i = 1; i < n; i++) {
+        size_t c = max(cuts.back(), end / n * i);
+        cuts.push_back(next_start(text, c, end));
+    }
+    cuts.push_back(end);
+    return cuts;
+}
+
+/*
+ * "src dst [weight]" lines, '#' and '%' start comments, the weight defaults to 1
+ */
+
+inline size_t edge_list_complete_until(const string &text) {
+    size_t nl = text.rfind('\n');
+    return nl == string::npos ? 0 : nl + 1;
+}
+
+inline size_t edge_list_next_line(const string &text, size_t pos, size_t end) {
+    if (pos == 0) {
+        return 0;
+    }
+    size_t nl = text.find('\n', pos - 1);
+    return nl == string::npos || nl >= end ? end : nl + 1;
+}
+
+inline void parse_edge_list_piece(const string &text, size_t begin, size_t end, Edge_List &edges) {
+    const char *data = text.c_str();
+    size_t pos = begin;
+    while (pos < end) {
+        size_t line_end = text.find('\n', pos);
+        if (line_end == string::npos || line_end > end) {
+            line_end = end;
+        }
+        const char *p = data + pos;
+        while (p < data + line_end && isspace(static_cast<unsigned char>(*p))) {
+            p++;
+        }
+        if (p < data + line_end && *p != '#' && *p != '%') {
+            char *after;
+            long long u = strtoll(p, &after, 10);
+            if (after == p) {
+                throw runtime_error("Malformed edge list line: " + text.substr(pos, line_end - pos));
+            }
+            p = after;
+            long long v = strtoll(p, &after, 10);
+            if (after == p || after > data + line_end) {
+                throw runtime_error("Malformed edge list line: " + text.substr(pos, line_end - pos));
+            }
+            p = after;
+            Dist_T w = strtod(p, &after);
+            if (after == p || after > data + line_end) {
+                w = 1;
+            }
+            // strtoll saturates on overflow, the ids must be valid vertices of the CSR arrays
+            if (u < 0 || v < 0 || u > numeric_limits<Node_id_T>::max() || v > numeric_limits<Node_id_T>::max()) {
+                throw runtime_error("Vertex id out of range in edge list line: " + text.substr(pos, line_end - pos));
+            }
+            edges.add_edge(static_cast<Node_id_T>(u), static_cast<Node_id_T>(v), w);
+        }
+        pos = line_end + 1;
+    }
+}
+
+/*
+ * GraphML: the <node> and <edge> elements are the records, a record runs until the next one starts.
+ * The vertices are numbered in order of first appearance like boost::read_graphml.
+ */
+
+inline bool is_tag_at(const string &text, size_t pos, const char *tag, size_t tag_len) {
+    if (text.compare(pos, tag_len, tag) != 0 || pos + tag_len >= text.size()) {
+        return false;
+    }
+    char c = text[pos + tag_len];
+    return isspace(static_cast<unsigned char>(c)) || c == '>' || c == '/';
+}
+
+inline size_t graphml_next_element(const string &text, size_t pos, size_t end) {
+    for (size_t p = text.find('<', pos); p != string::npos && p < end; p = text.find('<', p + 1)) {
+        if (is_tag_at(text, p, "<node", 5) || is_tag_at(text, p, "<edge", 5)) {
+            return p;
+        }
+    }
+    return end;
+}
+
+inline size_t graphml_complete_until(const string &text) {
+    size_t last = 0;
+    for (size_t p = text.rfind('<'); p != string::npos; p = p == 0 ? string::npos : text.rfind('<', p - 1)) {
+        if (is_tag_at(text, p, "<node", 5) || is_tag_at(text, p, "<edge", 5)) {
+            last = p;
+            break;
+        }
+    }
+    return last;
+}
+
+// value of attribute name in the start tag beginning at pos, empty if absent
+inline string xml_attribute(const string &text, size_t pos, size_t end, const string &name) {
+    size_t tag_end = text.find('>', pos);
+    if (tag_end == string::npos || tag_end > end) {
+        tag_end = end;
+    }
+    for (size_t p = text.find(name, pos); p != string::npos && p < tag_end; p = text.find(name, p + 1)) {
+        if (!isspace(static_cast<unsigned char>(text[p-1]))) {
+            continue;
+        }
+        size_t q = p + name.size();
+        while (q < tag_end && isspace(static_cast<unsigned char>(text[q]))) q++;
+        if (q >= tag_end || text[q] != '=') {
+            continue;
+        }
+        q++;
+        while (q < tag_end && isspace(static_cast<unsigned char>(text[q]))) q++;
+        if (q >= tag_end || (text[q] != '"' && text[q] != '\'')) {
+            continue;
+        }
+        size_t close = text.find(text[q], q + 1);
+        if (close == string::npos || close > tag_end) {
+            break;
+        }
+        return text.substr(q + 1, close - q - 1);
+    }
+    return "";
+}
+
+struct GraphML_Weight_Key {
+    string id; // empty when the file has no such key
+    Dist_T default_value = 1;
+};
+
+/**
+ * Finds the <key for="edge" attr.name=attr_name> declaration in the text before the first node or edge
+ */
+inline GraphML_Weight_Key parse_graphml_weight_key(const string &text, size_t end, const string &attr_name, Dist_T default_value) {
+    GraphML_Weight_Key key;
+    key.default_value = default_value;
+    for (size_t p = text.find("<key", 0); p != string::npos && p < end; p = text.find("<key", p + 1)) {
+        if (xml_attribute(text, p, end, "attr.name") != attr_name) {
+            continue;
+        }
+        string domain = xml_attribute(text, p, end, "for");
+        if (domain != "edge" && domain != "all") {
+            continue;
+        }
+        key.id = xml_attribute(text, p, end, "id");
+        size_t tag_end = text.find('>', p);
+        if (tag_end != string::npos && text[tag_end-1] != '/') { // <key ...>...</key> may hold a <default>
+            size_t close = text.find("</key>", tag_end);
+            size_t def = text.find("<default>", tag_end);
+            if (def != string::npos && def < close) {
+                key.default_value = strtod(text.c_str() + def + 9, nullptr);
+            }
+        }
+        break;
+    }
+    return key;
+}
+
+/**
+ * Edges of one piece with endpoints numbered in the piece, in order of first appearance
+ */
+struct GraphML_Piece {
+    vector<string> names;
+    unordered_map<string, Node_id_T> local_ids;
+    Edge_List edges;
+
+    Node_id_T local_id(const string &name) {
+        auto it = local_ids.emplace(name, static_cast<Node_id_T>(names.size()));
+        if (it.second) {
+            names.push_back(name);
+        }
+        return it.first->second;
+    }
+};
+
+inline void parse_graphml_piece(const string &text, size_t begin, size_t end, const GraphML_Weight_Key &key, GraphML_Piece &piece) {
+    for (size_t s = graphml_next_element(text, begin, end); s < end; ) {
+        size_t next = graphml_next_element(text, s + 1, end);
+        if (text[s+1] == 'n') {
+            piece.local_id(xml_attribute(text, s, next, "id"));
+        } else {
+            Node_id_T u = piece.local_id(xml_attribute(text, s, next, "source"));
+            Node_id_T v = piece.local_id(xml_attribute(text, s, next, "target"));
+            Dist_T w = key.default_value;
+            if (!key.id.empty()) {
+                for (size_t d = text.find("<data", s); d != string::npos && d < next; d = text.find("<data", d + 1)) {
+                    if (xml_attribute(text, d, next, "key") == key.id) {
+                        size_t value = text.find('>', d);
+                        w = strtod(text.c_str() + value + 1, nullptr);
+                        break;
+                    }
+                }
+            }
+            piece.edges.add_edge(u, v, w);
+        }
+        s = next;
+    }
+}
+
+#endif //STREAM_PARSER_HPP
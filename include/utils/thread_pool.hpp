@@ -0,0 +1,127 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Fixed set of workers that all run the same task, the calling thread takes part as worker 0.
+ * Work distribution is left to the task (e.g. an atomic counter over the items).
+ * run() is not reentrant: don't call it from inside a task.
+ */
+class Thread_Pool {
+public:
+    explicit Thread_Pool(int threads) : threads_count(max(1, threads)) {
+        workers.reserve(threads_count - 1);
+        for (int id = 1; id < threads_count; id++) {
+            workers.emplace_back(&Thread_Pool::worker_loop, this, id);
+        }
+    }
+
+    Thread_Pool(const Thread_Pool&) = delete;
+    Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+    ~Thread_Pool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        task_cv.notify_all();
+        for (auto &w : workers) {
+            w.join();
+        }
+    }
+
+    int size() const {
+        return threads_count;
+    }
+
+    /**
+     * Runs task(worker_id) on every worker and waits for all of them, the first exception thrown is rethrown here
+     * @param task called once per worker with an id in [0, size())
+     */
+    void run(const function<void(int)> &task) {
+        if (threads_count == 1) {
+            task(0);
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(mtx);
+            current_task = &task;
+            pending = threads_count - 1;
+            error = nullptr;
+            generation++;
+        }
+        task_cv.notify_all();
+
+        exception_ptr own_error = nullptr;
+        try {
+            task(0);
+        } catch (...) {
+            own_error = current_exception();
+        }
+
+        unique_lock<mutex> lock(mtx);
+        done_cv.wait(lock, [this] { return pending == 0; });
+        current_task = nullptr;
+        if (own_error) {
+            rethrow_exception(own_error);
+        }
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+
+private:
+    int threads_count;
+    vector<thread> workers;
+    mutex mtx;
+    condition_variable task_cv;
+    condition_variable done_cv;
+    const function<void(int)> *current_task = nullptr;
+    uint64_t generation = 0;
+    int pending = 0;
+    bool stopping = false;
+    exception_ptr error = nullptr;
+
+    void worker_loop(int id) {
+        uint64_t seen_generation = 0;
+        while (true) {
+            const function<void(int)> *task;
+            {
+                unique_lock<mutex> lock(mtx);
+                task_cv.wait(lock, [&] { return stopping || generation != seen_generation; });
+                if (stopping) {
+                    return;
+                }
+                seen_generation = generation;
+                task = current_task;
+            }
+
+            exception_ptr task_error = nullptr;
+            try {
+                (*task)(id);
+            } catch (...) {
+                task_error = current_exception();
+            }
+
+            lock_guard<mutex> lock(mtx);
+            if (task_error && !error) {
+                error = task_error;
+            }
+            if (--pending == 0) {
+                done_cv.notify_one();
+            }
+        }
+    }
+};
+
+#endif //THREAD_POOL_HPP
@@ -14,6 +14,11 @@ int main() {
     //runner.avg_time_of_x_vertices_as_src("random nodes_count=10000 edges_count=30000 max_weight=10 seed=" + to_string(RANDOM_SEED), 6);
     //runner.avg_time_of_x_vertices_as_src(string(PROJECT_ROOT) + "/data/1199167200.1199170800.graphml", 6);
     //runner.write_big_file(20000000, RANDOM_SEED);
+    //FileUtils::convert_bgp_graphml_to_csr_snapshot(string(PROJECT_ROOT) + "/data/1199167200.1199170800.graphml", string(PROJECT_ROOT) + "/data/1199167200.1199170800.csr");
+    //runner.tune_BMSSP_params("random nodes_count=100000 max_weight=10 seed=" + to_string(RANDOM_SEED), 8);
+    //runner.dynamic_updates("random nodes_count=100000 max_weight=10 seed=" + to_string(RANDOM_SEED), 20, 16, RANDOM_SEED);
+    //runner.save_results("random nodes_count=1000000 max_weight=10 seed=" + to_string(RANDOM_SEED), 4, RANDOM_SEED);
+    //runner.batch_of_x_vertices_as_src("random nodes_count=100000 max_weight=10 seed=" + to_string(RANDOM_SEED), 64, 8);
 
     return 0;
 }
\ No newline at end of file
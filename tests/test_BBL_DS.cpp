@@ -1,4 +1,5 @@
 #include "../data_structures/BBL_DS.hpp"
+#include "../data_structures/Pooled_BBL_DS.hpp"
 #include <gtest/gtest.h>
 
 using namespace std;
@@ -7,43 +8,48 @@ int M = 3;
 int B = 50000;
 int N = 50;
 
+// every storage engine must pass the same tests
+template<typename DS>
 class BBL_DS_Test : public ::testing::Test {
 protected:
-    BBL_DS<int, int> ds{};
+    DS ds{};
 
     void SetUp() override {
         ds.initialize(M, B, N);
     }
 };
 
-TEST_F(BBL_DS_Test, D1_insertion_and_pull_and_split) {
+using BBL_DS_Types = ::testing::Types<BBL_DS<int, int>, Pooled_BBL_DS<int, int>>;
+TYPED_TEST_SUITE(BBL_DS_Test, BBL_DS_Types);
+
+TYPED_TEST(BBL_DS_Test, D1_insertion_and_pull_and_split) {
     for (int i = 0; i < 6; i++) {
-        ds.insert_pair({i, i*5 + 2});
+        this->ds.insert_pair({i, i*5 + 2});
     }
     int x = 0;
-    auto keys = ds.pull(x);
-    auto D0_D1 = ds.get_sequences();
+    auto keys = this->ds.pull(x);
+    auto D0_D1 = this->ds.get_sequences();
 
-    EXPECT_FALSE(ds.empty());
+    EXPECT_FALSE(this->ds.empty());
     EXPECT_EQ(keys.size(), M);
     EXPECT_TRUE(x != B);
     EXPECT_EQ(x, 17); // smallest pair remaining {3, 17}
     EXPECT_EQ(D0_D1.first.size(), 0);
     EXPECT_GE(D0_D1.second.size(), 1);
-    EXPECT_EQ(ds.total_pairs(), 6 - M);
+    EXPECT_EQ(this->ds.total_pairs(), 6 - M);
 }
 
-TEST_F(BBL_DS_Test, D1_insert_duplicates_keep_lower_and_pull) {
+TYPED_TEST(BBL_DS_Test, D1_insert_duplicates_keep_lower_and_pull) {
     for (int i = 0; i < 6; i++) {
-        ds.insert_pair({i, i*5 + 2});
+        this->ds.insert_pair({i, i*5 + 2});
     }
-    ds.insert_pair({0, 0});
-    ds.insert_pair({1, 50});
-    ds.insert_pair({3, 6});
+    this->ds.insert_pair({0, 0});
+    this->ds.insert_pair({1, 50});
+    this->ds.insert_pair({3, 6});
     int x = 0;
-    EXPECT_FALSE(ds.empty());
-    EXPECT_EQ(ds.total_pairs(), 6);
-    auto keys = ds.pull(x);
+    EXPECT_FALSE(this->ds.empty());
+    EXPECT_EQ(this->ds.total_pairs(), 6);
+    auto keys = this->ds.pull(x);
     EXPECT_EQ(keys.size(), M);
     EXPECT_EQ(x, 12);
     EXPECT_TRUE(count(keys.begin(), keys.end(),0)
@@ -51,32 +57,82 @@ TEST_F(BBL_DS_Test, D1_insert_duplicates_keep_lower_and_pull) {
         && count(keys.begin(), keys.end(),3));
 }
 
-TEST_F(BBL_DS_Test, insert_and_delete_and_pull) {
+TYPED_TEST(BBL_DS_Test, insert_and_delete_and_pull) {
     for (int i = 0; i < 6; i++) {
-        ds.insert_pair({i, i*5 + 2});
+        this->ds.insert_pair({i, i*5 + 2});
     }
     for (int i = 0; i < 4; i++) {
-        ds.delete_pair({i, i*5 + 2});
+        this->ds.delete_pair({i, i*5 + 2});
     }
     int x = 0;
-    EXPECT_EQ(ds.total_pairs(), 2);
-    auto keys = ds.pull(x);
+    EXPECT_EQ(this->ds.total_pairs(), 2);
+    auto keys = this->ds.pull(x);
     EXPECT_LE(keys.size(), M);
     EXPECT_TRUE(count(keys.begin(), keys.end(),4) && count(keys.begin(), keys.end(),5));
-    EXPECT_TRUE(ds.empty());
+    EXPECT_TRUE(this->ds.empty());
     EXPECT_EQ(x, B); // D0 and D1 are empty
 }
 
-TEST_F(BBL_DS_Test, batch_prepend) {
+TYPED_TEST(BBL_DS_Test, batch_prepend) {
     vector<pair<int, int>> L1 = {{1, 1}, {2, 2}, {3, 3}, {6, 10}, {7, 7}};
     vector<pair<int, int>> L2 = {{4, 4}, {5, 5}, {3, 10}, {5, 6}, {3, 2}};
 
-    ds.batch_prepend(L1);
-    ds.batch_prepend(L2);
-    auto D0_D1 = ds.get_sequences();
+    this->ds.batch_prepend(L1);
+    this->ds.batch_prepend(L2);
+    auto D0_D1 = this->ds.get_sequences();
 
-    EXPECT_TRUE(ds.total_pairs() == 7);
+    EXPECT_TRUE(this->ds.total_pairs() == 7);
     EXPECT_EQ(D0_D1.second.size(), 1); // has one item from the initialization
     EXPECT_GE(D0_D1.first.size(), 1);
     EXPECT_EQ(D0_D1.first.size(), 3);
 }
+
+TYPED_TEST(BBL_DS_Test, reinitialize_and_pull_all_in_order) {
+    for (int round = 0; round < 2; round++) {
+        this->ds.initialize(M, B, N);
+        for (int i = N-1; i >= 0; i--) {
+            this->ds.insert_pair({i, i*7 % N + 1});
+        }
+        vector<pair<int, int>> L = {{3, 0}, {10, 0}};
+        this->ds.batch_prepend(L);
+
+        vector<int> seen(N, 0);
+        int x = 0;
+        int last_bound = 0;
+        while (!this->ds.empty()) {
+            auto keys = this->ds.pull(x);
+            EXPECT_LE(keys.size(), M);
+            EXPECT_GE(x, last_bound);
+            last_bound = x;
+            for (int key : keys) {
+                seen[key]++;
+            }
+        }
+        EXPECT_EQ(x, B);
+        EXPECT_EQ(count(seen.begin(), seen.end(), 1), N);
+    }
+}
+
+TYPED_TEST(BBL_DS_Test, reinitialize_forgets_previous_keys) {
+    for (int i = 0; i < 10; i++) {
+        this->ds.insert_pair({i, 100 + i});
+    }
+    this->ds.delete_pair({4, 104});
+
+    // a smaller then a larger key range, the keys of the previous use are gone
+    for (int n : {5, 2*N}) {
+        this->ds.initialize(M, B, n);
+        EXPECT_TRUE(this->ds.empty());
+        this->ds.insert_pair({n-1, 7});
+        this->ds.insert_pair({0, 9});
+        this->ds.insert_pair({0, 3}); // only the lower value is kept
+        this->ds.delete_pair({1, 8}); // not in the map
+        EXPECT_EQ(this->ds.total_pairs(), 2);
+
+        int x = 0;
+        vector<int> keys = this->ds.pull(x);
+        sort(keys.begin(), keys.end());
+        EXPECT_EQ(keys, vector<int>({0, n-1}));
+        EXPECT_EQ(x, B);
+    }
+}
@@ -0,0 +1,73 @@
+#include "../data_structures/Indexed_DAry_Heap.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+using namespace std;
+
+template<typename Heap>
+class Indexed_DAry_Heap_Test : public ::testing::Test {
+protected:
+    Heap heap{};
+};
+
+using Heap_Types = ::testing::Types<Indexed_DAry_Heap<int, 2>, Indexed_DAry_Heap<int, 4>, Indexed_DAry_Heap<int, 8>>;
+TYPED_TEST_SUITE(Indexed_DAry_Heap_Test, Heap_Types);
+
+TYPED_TEST(Indexed_DAry_Heap_Test, push_decrease_and_pop_in_order) {
+    this->heap.assign(10);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(this->heap.push_or_decrease(i, 100 - i));
+    }
+    EXPECT_FALSE(this->heap.push_or_decrease(3, 200)); // not a decrease
+    EXPECT_TRUE(this->heap.push_or_decrease(7, 5));
+    EXPECT_TRUE(this->heap.push_or_decrease(2, 1));
+    EXPECT_EQ(this->heap.size(), 10);
+    EXPECT_EQ(this->heap.peak_size(), 10);
+
+    EXPECT_EQ(this->heap.top_key(), 1);
+    EXPECT_EQ(this->heap.pop(), 2);
+    EXPECT_FALSE(this->heap.contains(2));
+    EXPECT_EQ(this->heap.pop(), 7);
+    vector<int> rest;
+    while (!this->heap.empty()) {
+        rest.push_back(this->heap.pop());
+    }
+    EXPECT_EQ(rest, vector<int>({9, 8, 6, 5, 4, 3, 1, 0}));
+}
+
+TYPED_TEST(Indexed_DAry_Heap_Test, matches_ordered_set) {
+    const int N = 300;
+    this->heap.assign(N);
+    set<pair<int, int>> expected;
+    vector<int> key(N, -1);
+    mt19937 rng(42);
+
+    for (int round = 0; round < 3; round++) {
+        for (int op = 0; op < 5000; op++) {
+            int item = rng() % N;
+            int k = rng() % 10000;
+            if (rng() % 4 == 0 && !expected.empty()) {
+                auto top = *expected.begin();
+                EXPECT_EQ(this->heap.top_key(), top.first);
+                int popped = this->heap.pop();
+                EXPECT_EQ(key[popped], top.first);
+                expected.erase({key[popped], popped});
+                key[popped] = -1;
+            } else if (key[item] < 0 || k < key[item]) {
+                EXPECT_TRUE(this->heap.push_or_decrease(item, k));
+                expected.erase({key[item], item});
+                expected.insert({k, item});
+                key[item] = k;
+            }
+            EXPECT_EQ(this->heap.size(), expected.size());
+        }
+        this->heap.clear(); // the positions must be usable again
+        expected.clear();
+        fill(key.begin(), key.end(), -1);
+        EXPECT_TRUE(this->heap.empty());
+        for (int i = 0; i < N; i++) {
+            EXPECT_FALSE(this->heap.contains(i));
+        }
+    }
+}
@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
 #include "../include/common.hpp"
 #include "../include/utils/graph_utils.hpp"
+#include "../include/dijkstras.hpp"
+#include "../include/bmssp.hpp"
+#include "../include/bmssp_autotune.hpp"
+#include "../include/bounded_sssp.hpp"
+#include "../include/bidirectional_dijkstra.hpp"
+#include "../include/dynamic_sssp.hpp"
+#include "../include/batch_sssp.hpp"
+#include "../include/delta_stepping.hpp"
+#include "../include/utils/result_io.hpp"
+#include "../include/many_to_many.hpp"
+#include "../include/sssp_cache.hpp"
 
 using namespace std;
 
@@ -150,4 +161,917 @@ TEST_F(Test_Utils, test_constant_degree_transformation_2ins_3_outs) {
     EXPECT_EQ(G_prime[2][6], 10);
     EXPECT_EQ(G_prime[3][7], 10);
     EXPECT_EQ(G_prime[7][0], 0);
-}
\ No newline at end of file
+}
+TEST_F(Test_Utils, test_constant_degree_transformation_csr) {
+    Edge_List edges = random_graph_edges(300, 20, 7);
+    edges.add_edge(4, 9, 3); // parallel edges and a self loop on a high degree vertex
+    edges.add_edge(4, 9, 1);
+    edges.add_edge(9, 9, 2);
+    CSR_Graph G(edges);
+    const int N = G.num_vertices();
+
+    for (int threads : {1, 3}) {
+        auto cd = constant_degree_transformation(G, threads);
+        const CSR_Graph &H = cd.graph;
+        ASSERT_EQ(cd.original_of.size(), static_cast<size_t>(H.num_vertices()));
+
+        vector<int> degree(H.num_vertices(), 0);
+        for (Node_id_T x = 0; x < H.num_vertices(); x++) {
+            for (const Edge &e : H.out_edges(x)) {
+                degree[x]++;
+                degree[e.to]++;
+            }
+        }
+        EXPECT_LE(*max_element(degree.begin(), degree.end()), 3);
+        for (Node_id_T v = 0; v < N; v++) {
+            EXPECT_EQ(cd.original_of[v], v);
+            for (Node_id_T x = cd.first_gadget[v]; x < cd.first_gadget[v+1]; x++) {
+                EXPECT_EQ(cd.original_of[x], v);
+            }
+        }
+
+        auto expected = min_heap_dijkstra(G, 0, N).first;
+        auto got = min_heap_dijkstra(H, 0, H.num_vertices()).first;
+        for (Node_id_T v = 0; v < N; v++) {
+            EXPECT_EQ(got[v], expected[v]);
+        }
+    }
+}
+
+TEST_F(Test_Utils, test_cylinder_knn_matches_brute_force) {
+    struct Params { uint64_t N; double r, h; int k, seed; };
+    for (const Params &p : {Params{2000, 10, 50, 4, 1}, Params{1500, 1, 0.01, 6, 2}, Params{800, 3, 0, 3, 3},
+                            Params{5, 1, 1, 8, 4}}) {
+        Edge_List expected(p.N);
+        {
+            vector<tuple<double, double, double>> points;
+            mt19937 rng(p.seed);
+            uniform_real_distribution<> angle_dist(0.0, 2*M_PI);
+            uniform_real_distribution<> z_dist(-1*p.h/2, p.h/2);
+            for (uint64_t i = 0; i < p.N; i++) {
+                double phi = angle_dist(rng);
+                double z = z_dist(rng);
+                points.emplace_back(p.r*cos(phi), p.r*sin(phi), z);
+            }
+            for (uint64_t i = 0; i < p.N; i++) {
+                vector<pair<double, uint64_t>> dists;
+                for (uint64_t j = 0; j < p.N; j++) {
+                    dists.emplace_back(sqrt(pow(get<0>(points[i])-get<0>(points[j]), 2) + pow(get<1>(points[i])-get<1>(points[j]), 2)
+                                            + pow(get<2>(points[i])-get<2>(points[j]), 2)), j);
+                }
+                sort(dists.begin(), dists.end());
+                for (uint64_t j = 0; j < min<uint64_t>(p.k+1, p.N); j++) {
+                    if (dists[j].second != i) {
+                        expected.add_edge(i, dists[j].second, dists[j].first);
+                    }
+                }
+            }
+        }
+
+        for (int threads : {1, 3}) {
+            Edge_List got = cylinder_knn_graph_edges(p.N, p.r, p.h, p.k, p.seed, threads);
+            EXPECT_EQ(got.sources, expected.sources);
+            EXPECT_EQ(got.targets, expected.targets);
+            EXPECT_EQ(got.weights, expected.weights);
+        }
+    }
+}
+
+TEST_F(Test_Utils, test_indexed_heap_engines_match_min_heap_dijkstra) {
+    CSR_Graph G(random_barabasi_albert_edges(5, 3, 3000, 10, 321));
+    const int N = G.num_vertices();
+    Indexed_Dijkstra_State<4> dijkstra_state(G);
+    Indexed_Heap_BMSSP_State bmssp_state(G);
+    for (Node_id_T src : {0, 17, 2500}) {
+        auto expected = min_heap_dijkstra(G, src, N).first;
+        EXPECT_EQ(indexed_dijkstra_query(dijkstra_state, src, N).first, expected);
+        EXPECT_EQ(indexed_heap_dijkstra<2>(G, src, N).first, expected);
+        EXPECT_EQ(BMSSP_query(bmssp_state, src, N).first, expected);
+        EXPECT_LE(dijkstra_state.peak_heap_size, static_cast<size_t>(N));
+    }
+}
+
+TEST_F(Test_Utils, test_batch_sssp_matches_single_queries) {
+    for (const CSR_Graph &G : {CSR_Graph(random_graph_edges(3000, 10, 11)), CSR_Graph(grid_graph_edges(40, 30))}) {
+        const int N = G.num_vertices();
+        const vector<Node_id_T> sources = {0, 5, 1199, 42, 5, N-1, 17, 300, 901}; // 5 twice
+        Dijkstra_State single(G);
+        vector<SSSP_Result> expected;
+        for (const Node_id_T &s : sources) {
+            expected.push_back(dijkstra_query(single, s, N));
+        }
+        auto query = [](Dijkstra_State &state, Node_id_T s, int n) { return dijkstra_query(state, s, n); };
+
+        for (int threads : {1, 2, 4}) {
+            // results in source order
+            vector<SSSP_Result> results = batch_sssp<Dijkstra_State>(G, sources, threads, query);
+            ASSERT_EQ(results.size(), sources.size());
+            for (size_t i = 0; i < sources.size(); i++) {
+                EXPECT_EQ(results[i], expected[i]) << "source " << sources[i] << ", " << threads << " threads";
+            }
+
+            // callback on a shared pool, each index once with its source
+            Thread_Pool pool(threads);
+            mutex mtx;
+            vector<int> calls(sources.size(), 0);
+            for (int round = 0; round < 2; round++) { // the pool is reused
+                batch_sssp<Dijkstra_State>(G, sources, pool, query, [&](size_t idx, Node_id_T src, SSSP_Result &result) {
+                    lock_guard<mutex> lock(mtx);
+                    calls[idx]++;
+                    EXPECT_EQ(src, sources[idx]);
+                    EXPECT_EQ(result, expected[idx]);
+                });
+            }
+            EXPECT_EQ(calls, vector<int>(sources.size(), 2));
+        }
+    }
+}
+
+TEST_F(Test_Utils, test_parallel_pivots_match_serial_bmssp) {
+    // min_frontier = 1 sends every find_pivots round to the workers, the grid's unit weights tie many lengths
+    for (const CSR_Graph &G : {CSR_Graph(random_graph_edges(5000, 10, 13)), CSR_Graph(grid_graph_edges(70, 50))}) {
+        const int N = G.num_vertices();
+        BMSSP_State serial(G);
+        for (int threads : {2, 4, 8}) {
+            Thread_Pool pool(threads);
+            BMSSP_State parallel(G);
+            parallel.enable_parallel_pivots(pool, 1);
+            for (Node_id_T src : {0, N/2, N-1}) {
+                auto expected = BMSSP_query(serial, src, N);
+                EXPECT_EQ(expected.first, min_heap_dijkstra(G, src, N).first);
+                EXPECT_EQ(BMSSP_query(parallel, src, N).first, expected.first) << threads << " threads from " << src;
+                for (Node_id_T v = 0; v < N; v++) {
+                    ASSERT_EQ(parallel.paths.alpha(v), serial.paths.alpha(v)) << "vertex " << v;
+                }
+            }
+        }
+        EXPECT_EQ(parallel_top_level_BMSSP(G, 1, N, 4, 1).first, min_heap_dijkstra(G, 1, N).first);
+    }
+}
+
+TEST_F(Test_Utils, test_soa_bmssp_matches_aos) {
+    for (const CSR_Graph &G : {CSR_Graph(random_graph_edges(5000, 10, 17)), CSR_Graph(grid_graph_edges(70, 50))}) {
+        const int N = G.num_vertices();
+        BMSSP_State aos(G);
+        SoA_BMSSP_State soa(G);
+        for (Node_id_T src : {0, N/3, N-1}) {
+            auto expected = BMSSP_query(aos, src, N);
+            auto got = BMSSP_query(soa, src, N); // the state is reused
+            EXPECT_EQ(got.first, expected.first) << "from " << src;
+            EXPECT_EQ(got.second, expected.second) << "from " << src;
+        }
+        EXPECT_EQ(soa_top_level_BMSSP(G, 1, N).first, min_heap_dijkstra(G, 1, N).first);
+    }
+}
+
+TEST_F(Test_Utils, test_pooled_bmssp_matches_bbl_ds) {
+    for (const CSR_Graph &G : {CSR_Graph(random_graph_edges(5000, 10, 19)), CSR_Graph(grid_graph_edges(70, 50))}) {
+        const int N = G.num_vertices();
+        BMSSP_State plain(G);
+        Pooled_BMSSP_State pooled(G);
+        for (Node_id_T src : {0, N/3, N-1}) {
+            auto expected = BMSSP_query(plain, src, N);
+            auto got = BMSSP_query(pooled, src, N); // the pools are reused between queries
+            EXPECT_EQ(got.first, expected.first) << "from " << src;
+            EXPECT_EQ(got.second, expected.second) << "from " << src;
+        }
+        EXPECT_EQ(pooled_top_level_BMSSP(G, 1, N).first, min_heap_dijkstra(G, 1, N).first);
+    }
+}
+
+TEST_F(Test_Utils, test_delta_stepping_matches_min_heap_dijkstra) {
+    for (const Edge_List &edges : {random_graph_edges(3000, 10, 23), random_barabasi_albert_edges(5, 3, 3000, 10, 29)}) {
+        Edge_List with_sink = edges;
+        const Node_id_T sink = CSR_Graph(edges).num_vertices();
+        with_sink.add_edge(0, sink, 1); // reached but without out-edges
+        CSR_Graph G(with_sink);
+        const int N = G.num_vertices();
+        for (Dist_T delta : {0.01, 0.0, 4 * G.max_weight()}) { // tiny, default_delta, a single bucket
+            for (int threads : {1, 2, 4}) {
+                for (Node_id_T src : {0, N/2}) {
+                    EXPECT_EQ(delta_stepping(G, src, N, delta, threads).first, min_heap_dijkstra(G, src, N).first)
+                        << "delta " << delta << ", " << threads << " threads from " << src;
+                }
+                auto alone = delta_stepping(G, sink, N, delta, threads);
+                EXPECT_EQ(alone.first, min_heap_dijkstra(G, sink, N).first);
+                EXPECT_EQ(count(alone.first.begin(), alone.first.end(), INF), N-1);
+            }
+        }
+    }
+
+    // the same state for several queries
+    CSR_Graph G(random_graph_edges(2000, 10, 31));
+    const int N = G.num_vertices();
+    Thread_Pool pool(3);
+    Delta_Stepping_State state(G, pool);
+    for (Node_id_T src : {0, 7, N-1}) {
+        EXPECT_EQ(delta_stepping_query(state, src, N).first, min_heap_dijkstra(G, src, N).first);
+    }
+}
+
+template<typename Weight>
+vector<Dist_T> widened(const vector<Weight> &dist) {
+    vector<Dist_T> sortie;
+    for (const Weight &d : dist) {
+        sortie.push_back(d == infinity_of<Weight>() ? INF : static_cast<Dist_T>(d));
+    }
+    return sortie;
+}
+
+TEST_F(Test_Utils, test_32_bits_engines_match_double) {
+    EXPECT_EQ(infinity_of<double>(), numeric_limits<double>::infinity());
+    EXPECT_EQ(infinity_of<uint32_t>(), UINT32_MAX);
+
+    Edge_List edges = random_barabasi_albert_edges(5, 3, 3000, 20, 77);
+    for (Dist_T &w : edges.weights) {
+        w = round(w);
+    }
+    edges.add_edge(3005, 3006, 1); // unreachable from the sources
+    CSR_Graph G(edges);
+    ASSERT_TRUE(G.weights_fit<float>());
+    ASSERT_TRUE(G.weights_fit<uint32_t>());
+    EXPECT_FALSE(CSR_Graph(random_graph_edges(100, 10, 3)).weights_fit<uint32_t>());
+
+    F32_CSR_Graph F(G);
+    U32_CSR_Graph U(G);
+    EXPECT_EQ(U.num_edges(), G.num_edges());
+    EXPECT_EQ(U.max_weight(), static_cast<uint32_t>(G.max_weight()));
+    const int N = G.num_vertices();
+    F32_BMSSP_State f_bmssp(F);
+    U32_BMSSP_State u_bmssp(U);
+    F32_Dijkstra_State f_dijkstra(F);
+    U32_Dijkstra_State u_dijkstra(U);
+    for (Node_id_T src : {0, 17, 2500}) {
+        auto expected = min_heap_dijkstra(G, src, N);
+        EXPECT_EQ(widened(BMSSP_query(f_bmssp, src, N).first), expected.first);
+        EXPECT_EQ(widened(BMSSP_query(u_bmssp, src, N).first), expected.first);
+        EXPECT_EQ(widened(dijkstra_query(f_dijkstra, src, N).first), expected.first);
+        EXPECT_EQ(widened(dijkstra_query(u_dijkstra, src, N).first), expected.first);
+        EXPECT_EQ(BMSSP_query(u_bmssp, src, N).first[3006], UINT32_MAX);
+    }
+}
+
+TEST_F(Test_Utils, test_u32_lengths_saturate) {
+    EXPECT_EQ(saturating_add<uint32_t>(UINT32_MAX - 3, 3), UINT32_MAX);
+    EXPECT_EQ(saturating_add<uint32_t>(UINT32_MAX - 3, 4), UINT32_MAX);
+    EXPECT_EQ(saturating_add<uint32_t>(UINT32_MAX / 2, UINT32_MAX / 2), UINT32_MAX - 1);
+
+    // 0 -> 1 -> 2 wraps around to 2 in 32 bits, below the real shortest path 0 -> 3 -> 2
+    const Dist_T heavy = UINT32_MAX / 2 + 2;
+    Edge_List edges(5);
+    edges.add_edge(0, 1, heavy);
+    edges.add_edge(1, 2, heavy);
+    edges.add_edge(0, 3, 10);
+    edges.add_edge(3, 2, 10);
+    edges.add_edge(1, 4, heavy); // only reachable past UINT32_MAX
+    CSR_Graph G(edges);
+    ASSERT_TRUE(G.weights_fit<uint32_t>());
+
+    U32_CSR_Graph U(G);
+    U32_BMSSP_State bmssp(U);
+    U32_Dijkstra_State dijkstra(U);
+    const vector<uint32_t> expected({0, static_cast<uint32_t>(heavy), 20, 10, UINT32_MAX});
+    EXPECT_EQ(BMSSP_query(bmssp, 0, 5).first, expected);
+    EXPECT_EQ(dijkstra_query(dijkstra, 0, 5).first, expected);
+    EXPECT_EQ(BMSSP_query(bmssp, 0, 5).second[2], 3);
+    EXPECT_EQ(min_heap_dijkstra(U, 0, 5).first, expected);
+    EXPECT_EQ(indexed_heap_dijkstra<4>(U, 0, 5).first, expected);
+    EXPECT_EQ(bucket_dijkstra(U, 0, 5).first, expected);
+    EXPECT_EQ(fibo_heap_dijkstra(U, 0, 5).first, expected);
+    EXPECT_EQ(delta_stepping(U, 0, 5, 0, 2).first, expected);
+    EXPECT_EQ(bidirectional_dijkstra(U, 0, 2).first, 20u);
+    EXPECT_EQ(bidirectional_dijkstra(U, 0, 4).first, UINT32_MAX);
+}
+
+/**
+ * Every engine on g, a copy of G with other weight or id types, against min_heap_dijkstra on G
+ */
+template<typename Weight, typename Id>
+void expect_engines_match(const Basic_CSR_Graph<Weight, Id> &g, const CSR_Graph &G, Id src) {
+    const int N = g.num_vertices();
+    const Dist_List_T expected = min_heap_dijkstra(G, static_cast<Node_id_T>(src), N).first;
+    EXPECT_EQ(widened(min_heap_dijkstra(g, src, N).first), expected);
+    EXPECT_EQ(widened(indexed_heap_dijkstra<4>(g, src, N).first), expected);
+    EXPECT_EQ(widened(dial_dijkstra(g, src, N).first), expected);
+    EXPECT_EQ(widened(radix_heap_dijkstra(g, src, N).first), expected);
+    EXPECT_EQ(widened(fibo_heap_dijkstra(g, src, N).first), expected);
+    EXPECT_EQ(widened(delta_stepping(g, src, N, 0, 2).first), expected);
+    Basic_Dijkstra_State<Weight, Id> dijkstra(g);
+    EXPECT_EQ(widened(dijkstra_query(dijkstra, src, N).first), expected);
+    Basic_BMSSP_State<Basic_AoS_Paths<Weight, Id>> bmssp(g);
+    EXPECT_EQ(widened(BMSSP_query(bmssp, src, N).first), expected);
+    Basic_BMSSP_State<Basic_SoA_Paths<Weight, Id>> soa_bmssp(g);
+    EXPECT_EQ(widened(BMSSP_query(soa_bmssp, src, N).first), expected);
+
+    Basic_Bounded_Dijkstra_State<Weight, Id> bounded(g);
+    auto reached = bounded_dijkstra_query(bounded, src, Bounded_Query());
+    EXPECT_EQ(static_cast<long>(reached.nodes.size()), N - count(expected.begin(), expected.end(), INF));
+    for (size_t i = 0; i < reached.nodes.size(); i++) {
+        EXPECT_EQ(static_cast<Dist_T>(reached.dist[i]), expected[reached.nodes[i]]);
+    }
+
+    Basic_Bidirectional_Dijkstra_State<Weight, Id> bidirectional(g);
+    for (Id t : {Id(0), Id(N/2), Id(N-1)}) {
+        EXPECT_EQ(widened(vector<Weight>{bidirectional_dijkstra_query(bidirectional, src, t).first})[0], expected[t]);
+    }
+
+    // drops the first edge of src and repairs the tree
+    Basic_Dynamic_SSSP_State<Weight, Id> dynamic(g, src, min_heap_dijkstra(g, src, N));
+    ASSERT_FALSE(g.out_edges(src).empty());
+    const Id first = (*g.out_edges(src).begin()).to;
+    dynamic_sssp_update(dynamic, vector<Basic_Edge_Update<Weight, Id>>{{src, first, infinity_of<Weight>()}});
+    EXPECT_EQ(dynamic.dist, min_heap_dijkstra(dynamic.to_csr_graph(), src, N).first);
+}
+
+TEST_F(Test_Utils, test_engines_on_other_weight_and_id_types) {
+    Edge_List edges = random_barabasi_albert_edges(5, 3, 2000, 20, 13);
+    for (Dist_T &w : edges.weights) {
+        w = round(w);
+    }
+    edges.add_edge(2005, 2006, 1); // unreachable from the sources
+    CSR_Graph G(edges);
+    ASSERT_TRUE(G.weights_fit<float>());
+    ASSERT_TRUE(G.weights_fit<uint32_t>());
+
+    const F32_CSR_Graph F(G);
+    const U32_CSR_Graph U(G);
+    const Basic_CSR_Graph<Dist_T, int64_t> L(G);
+    const Basic_CSR_Graph<uint32_t, int64_t> UL(G);
+    EXPECT_EQ(L.num_edges(), G.num_edges());
+    for (Node_id_T src : {0, 1000}) {
+        expect_engines_match(F, G, src);
+        expect_engines_match(U, G, src);
+        expect_engines_match(L, G, static_cast<int64_t>(src));
+        expect_engines_match(UL, G, static_cast<int64_t>(src));
+    }
+}
+
+TEST_F(Test_Utils, test_pivot_forest) {
+    AoS_Paths paths;
+    paths.assign(7);
+    paths.set(1, Path_T(1, 1, 1, 0));
+    paths.set(2, Path_T(1, 1, 2, 0));
+    paths.set(3, Path_T(2, 2, 3, 2));
+    paths.set(5, Path_T(3, 2, 5, 4)); // its parent is outside W
+    boost::dynamic_bitset<> W(7);
+    for (int v : {0, 1, 2, 3, 5}) W.set(v);
+
+    Pivot_Forest forest;
+    forest.build(W, paths);
+    EXPECT_EQ(forest.members, vector<Node_id_T>({0, 1, 2, 3, 5}));
+    EXPECT_EQ(forest.rank(5), 4);
+    EXPECT_TRUE(forest.is_root(forest.rank(0)));
+    EXPECT_TRUE(forest.is_root(forest.rank(5)));
+    EXPECT_FALSE(forest.is_root(forest.rank(3)));
+    EXPECT_TRUE(forest.subtree_size_at_least_k(forest.rank(0), 4));
+    EXPECT_FALSE(forest.subtree_size_at_least_k(forest.rank(0), 5));
+    EXPECT_TRUE(forest.subtree_size_at_least_k(forest.rank(2), 2));
+    EXPECT_TRUE(forest.subtree_size_at_least_k(forest.rank(5), 1));
+    EXPECT_FALSE(forest.subtree_size_at_least_k(forest.rank(5), 2));
+
+    W.reset(2); // rebuilt smaller, 3 becomes a root
+    forest.build(W, paths);
+    EXPECT_EQ(forest.children.size(), 1u);
+    EXPECT_TRUE(forest.is_root(forest.rank(3)));
+    EXPECT_FALSE(forest.subtree_size_at_least_k(forest.rank(0), 3));
+}
+
+TEST_F(Test_Utils, test_bmssp_params) {
+    CSR_Graph G(random_graph(4000, 10, 5));
+    const int N = G.num_vertices();
+    const BMSSP_Params paper = BMSSP_Params().resolved(N);
+    EXPECT_EQ(paper, BMSSP_Params(2, 5, 3)); // log2(4000) ~ 11.97
+    EXPECT_EQ(BMSSP_Params(3, 4, 1).resolved(N), BMSSP_Params(3, 4, 3)); // too shallow to reach every vertex
+
+    BMSSP_State state(G);
+    for (Node_id_T src : {0, 1999}) {
+        auto expected = min_heap_dijkstra(G, src, N).first;
+        for (const BMSSP_Params &params : {BMSSP_Params(), BMSSP_Params(1, 1), BMSSP_Params(4, 2, 9), BMSSP_Params(2, 12),
+                                           BMSSP_Params(0, 0, 0, 64), BMSSP_Params(0, 0, 0, 5000), BMSSP_Params(1, 2, 0, 100000)}) {
+            state.params = params;
+            EXPECT_EQ(BMSSP_query(state, src, N).first, expected) << params.to_string();
+        }
+        EXPECT_EQ(top_level_BMSSP_with_params(G, src, N, BMSSP_Params(3, 3)).first, expected);
+    }
+}
+
+TEST_F(Test_Utils, test_bmssp_hybrid_on_ties) {
+    // the unit weights of a grid give many paths of equal length, each vertex must still be completed once
+    CSR_Graph G(grid_graph_edges(60, 40));
+    const int N = G.num_vertices();
+    BMSSP_State state(G);
+    for (int cutoff : {0, 16, 1000, N, 1 << 30}) {
+        state.params.hybrid_cutoff = cutoff;
+        EXPECT_EQ(BMSSP_query(state, 0, N).first, min_heap_dijkstra(G, 0, N).first) << cutoff;
+    }
+
+    state.reset(0);
+    vector<Node_id_T> S = {0};
+    auto all = bounded_dijkstra_of_BMSSP(state, N, Path_T{}, S);
+    EXPECT_EQ(static_cast<int>(all.second.size()), N);
+    EXPECT_EQ(all.first, Path_T{});
+}
+
+TEST_F(Test_Utils, test_bmssp_autotune) {
+    CSR_Graph G(random_graph(2000, 10, 8));
+    CSR_Graph H(random_graph(2000, 10, 9));
+    EXPECT_EQ(graph_fingerprint(G), graph_fingerprint(CSR_Graph(G.to_graph())));
+    EXPECT_NE(graph_fingerprint(G), graph_fingerprint(H));
+
+    vector<BMSSP_Params> candidates = {BMSSP_Params(1, 2), BMSSP_Params(2, 3), BMSSP_Params(3, 4, 5)};
+    BMSSP_Tuning tuning = autotune_BMSSP(G, 3, 1234, candidates);
+    bool is_candidate = false;
+    for (const BMSSP_Params &c : candidates) {
+        is_candidate = is_candidate || c.resolved(G.num_vertices()) == tuning.params;
+    }
+    EXPECT_TRUE(is_candidate);
+    EXPECT_GT(tuning.ms_per_query, 0);
+
+    string filename = ::testing::TempDir() + "test_utils_bmssp_params.txt";
+    remove(filename.c_str());
+    BMSSP_Tuning read;
+    EXPECT_FALSE(load_BMSSP_params(filename, graph_fingerprint(G), read));
+    save_BMSSP_params(filename, graph_fingerprint(G), tuning);
+    save_BMSSP_params(filename, graph_fingerprint(H), BMSSP_Tuning{BMSSP_Params(1, 1, 11), 2.5});
+    save_BMSSP_params(filename, graph_fingerprint(H), BMSSP_Tuning{BMSSP_Params(2, 2, 6, 256), 1.5}); // replaces H's line
+
+    ASSERT_TRUE(load_BMSSP_params(filename, graph_fingerprint(G), read));
+    EXPECT_EQ(read.params, tuning.params);
+    ASSERT_TRUE(load_BMSSP_params(filename, graph_fingerprint(H), read));
+    EXPECT_EQ(read.params, BMSSP_Params(2, 2, 6, 256));
+    EXPECT_EQ(read.ms_per_query, 1.5);
+    EXPECT_EQ(tuned_BMSSP_params(H, filename).params, BMSSP_Params(2, 2, 6, 256)); // already tuned
+    remove(filename.c_str());
+}
+
+TEST_F(Test_Utils, test_bounded_queries) {
+    Graph boost_graph = random_graph(4000, 10, 99);
+    CSR_Graph G(boost_graph);
+    const int N = G.num_vertices();
+    Bounded_Dijkstra_State dijkstra_state(G);
+    Bounded_Boost_State boost_state(boost_graph);
+    BMSSP_State bmssp_state(G);
+
+    for (Node_id_T src : {0, 123, 3999}) {
+        auto full = min_heap_dijkstra(G, src, N).first;
+        vector<Dist_T> reached;
+        for (Dist_T d : full) {
+            if (d < INF) reached.push_back(d);
+        }
+        sort(reached.begin(), reached.end());
+        const Dist_T radius = reached[reached.size() / 4];
+        auto within = count_if(full.begin(), full.end(), [&](Dist_T d) { return d <= radius; });
+
+        Bounded_Query by_radius;
+        by_radius.radius = radius;
+        for (const Bounded_Result &res : {bounded_dijkstra_query(dijkstra_state, src, by_radius),
+                                          bounded_boost_dijkstra(boost_state, src, by_radius),
+                                          bounded_BMSSP_query(bmssp_state, src, by_radius)}) {
+            EXPECT_EQ(static_cast<long>(res.nodes.size()), within);
+            for (size_t i = 0; i < res.nodes.size(); i++) {
+                EXPECT_EQ(res.dist[i], full[res.nodes[i]]);
+            }
+        }
+
+        Bounded_Query by_targets;
+        for (Node_id_T v = 0; v < N && by_targets.targets.size() < 2; v++) {
+            if (full[v] > 0 && full[v] <= radius) by_targets.targets.push_back(v);
+        }
+        for (const Bounded_Result &res : {bounded_dijkstra_query(dijkstra_state, src, by_targets),
+                                          bounded_boost_dijkstra(boost_state, src, by_targets)}) {
+            EXPECT_LE(static_cast<long>(res.nodes.size()), within); // stopped at the targets
+            for (Node_id_T t : by_targets.targets) {
+                auto it = find(res.nodes.begin(), res.nodes.end(), t);
+                ASSERT_TRUE(it != res.nodes.end());
+                EXPECT_EQ(res.dist[it - res.nodes.begin()], full[t]);
+            }
+        }
+    }
+}
+
+TEST_F(Test_Utils, test_bounded_32_bits_BMSSP) {
+    Edge_List edges = random_barabasi_albert_edges(5, 3, 3000, 20, 41);
+    for (Dist_T &w : edges.weights) {
+        w = round(w);
+    }
+    CSR_Graph G(edges);
+    ASSERT_TRUE(G.weights_fit<float>());
+    ASSERT_TRUE(G.weights_fit<uint32_t>());
+    F32_CSR_Graph F(G);
+    U32_CSR_Graph U(G);
+    F32_BMSSP_State f_state(F);
+    U32_BMSSP_State u_state(U);
+    const int N = G.num_vertices();
+
+    for (Node_id_T src : {0, 1500}) {
+        auto full = min_heap_dijkstra(G, src, N).first;
+        vector<Dist_T> reached;
+        for (Dist_T d : full) {
+            if (d < INF) reached.push_back(d);
+        }
+        sort(reached.begin(), reached.end());
+        const Dist_T median = reached[reached.size() / 2];
+        // a radius on a distance keeps the vertices at that distance, a fractional one rounds down in integers
+        for (Dist_T radius : {median, median + 0.5, median - 0.5, INF}) {
+            auto within = count_if(full.begin(), full.end(), [&](Dist_T d) { return d <= radius; });
+            Bounded_Query query;
+            query.radius = radius;
+            auto check = [&](const auto &res) {
+                EXPECT_EQ(static_cast<long>(res.nodes.size()), within) << "radius " << radius;
+                for (size_t i = 0; i < res.nodes.size(); i++) {
+                    EXPECT_EQ(static_cast<Dist_T>(res.dist[i]), full[res.nodes[i]]);
+                }
+            };
+            check(bounded_BMSSP_query(f_state, src, query));
+            check(bounded_BMSSP_query(u_state, src, query));
+        }
+    }
+}
+
+TEST_F(Test_Utils, test_csr_graph_transpose) {
+    Edge_List edges(4);
+    edges.add_edge(0, 1, 1);
+    edges.add_edge(2, 1, 2);
+    edges.add_edge(1, 3, 3);
+    edges.add_edge(0, 3, 4);
+    CSR_Graph T = CSR_Graph(edges).transpose();
+
+    EXPECT_EQ(T.num_vertices(), 4);
+    EXPECT_EQ(T.num_edges(), 4);
+    EXPECT_EQ(T.out_degree(0), 0);
+    ASSERT_EQ(T.out_degree(1), 2);
+    EXPECT_EQ(T.target(T.edges_begin(1)), 0);
+    EXPECT_EQ(T.target(T.edges_begin(1) + 1), 2);
+    EXPECT_EQ(T.weight(T.edges_begin(1) + 1), 2);
+    ASSERT_EQ(T.out_degree(3), 2);
+    EXPECT_EQ(T.target(T.edges_begin(3)), 0);
+    EXPECT_EQ(T.weight(T.edges_begin(3)), 4);
+}
+
+TEST_F(Test_Utils, test_bidirectional_dijkstra) {
+    CSR_Graph G(random_graph_edges(3000, 10, 77));
+    const int N = G.num_vertices();
+    Bidirectional_Dijkstra_State state(G);
+    mt19937 rng(5);
+
+    for (int q = 0; q < 30; q++) {
+        Node_id_T s = rng() % N, t = q == 0 ? s : rng() % N;
+        auto full = min_heap_dijkstra(G, s, N).first;
+        auto res = bidirectional_dijkstra_query(state, s, t);
+        if (full[t] == INF) {
+            EXPECT_EQ(res.first, INF);
+            EXPECT_TRUE(res.second.empty());
+            continue;
+        }
+        EXPECT_NEAR(res.first, full[t], 1e-9 * full[t]); // the two halves are summed separately
+        ASSERT_FALSE(res.second.empty());
+        EXPECT_EQ(res.second.front(), s);
+        EXPECT_EQ(res.second.back(), t);
+        Dist_T length = 0;
+        for (size_t i = 0; i + 1 < res.second.size(); i++) {
+            Dist_T best = INF;
+            for (const Edge &e : G.out_edges(res.second[i])) {
+                if (e.to == res.second[i+1]) best = min(best, e.w);
+            }
+            ASSERT_LT(best, INF);
+            length += best;
+        }
+        EXPECT_NEAR(length, full[t], 1e-9 * full[t]);
+    }
+}
+
+TEST_F(Test_Utils, test_dynamic_sssp_updates) {
+    CSR_Graph G(random_barabasi_albert_edges(3, 2, 2000, 10, 99));
+    const Node_id_T src = 5;
+    Graph boost_graph = G.to_graph();
+    Dynamic_SSSP_State state(G, src, boost_dijkstra(boost_graph, src, G.num_vertices()));
+
+    mt19937 rng(7);
+    for (int batch = 0; batch < 30; batch++) {
+        const int N = state.num_vertices();
+        uniform_int_distribution<Node_id_T> pick(0, N-1);
+        vector<Edge_Update> updates;
+        for (int i = 0; i < 1 + batch % 7; i++) {
+            Node_id_T u = pick(rng);
+            switch (rng() % 5) {
+                case 0: // delete or reweight a tree edge, the hardest case
+                    if (state.parent[u] >= 0) {
+                        updates.push_back({state.parent[u], u, rng() % 2 ? INF : state.dist[u] + 5});
+                    }
+                    break;
+                case 1: updates.push_back({u, pick(rng), static_cast<Dist_T>(rng() % 10)}); break;
+                case 2: updates.push_back({u, pick(rng), INF}); break;
+                case 3: updates.push_back({u, N + static_cast<int>(rng() % 3), 1}); break; // new vertices
+                default: if (!state.out[u].empty()) updates.push_back({u, state.out[u][0].to, 0.5});
+            }
+        }
+        const Dist_List_T before = state.dist;
+        const size_t changed = dynamic_sssp_update(state, updates);
+
+        CSR_Graph H = state.to_csr_graph();
+        auto expected = min_heap_dijkstra(H, src, H.num_vertices());
+        ASSERT_EQ(state.dist, expected.first) << batch;
+        size_t differing = 0;
+        for (Node_id_T v = 0; v < H.num_vertices(); v++) {
+            differing += v >= static_cast<Node_id_T>(before.size()) ? expected.first[v] < INF : before[v] != expected.first[v];
+            if (v != src && state.dist[v] < INF) { // the parents still form a shortest path tree
+                ASSERT_EQ(state.dist[state.parent[v]] + edge_weight(state, state.parent[v], v), state.dist[v]);
+            }
+        }
+        EXPECT_EQ(changed, differing);
+    }
+
+    // the updates between two graphs numbered alike
+    CSR_Graph K(random_barabasi_albert_edges(3, 2, 2100, 10, 98));
+    CSR_Graph current = state.to_csr_graph();
+    dynamic_sssp_update(state, edge_updates_between(current, K));
+    EXPECT_EQ(state.dist, min_heap_dijkstra(K, src, K.num_vertices()).first);
+    EXPECT_TRUE(edge_updates_between(K, K).empty());
+}
+
+#ifdef BMSSP_COUNTERS
+TEST_F(Test_Utils, test_op_counters) {
+    CSR_Graph G(random_graph(3000, 10, 7));
+    BMSSP_State state(G);
+    op_counters().reset();
+    BMSSP_query(state, 0, G.num_vertices());
+
+    const Op_Counters &c = op_counters();
+    EXPECT_GT(c.bmssp_calls, 0u);
+    EXPECT_EQ(c.recursion_depth, 0u);
+    EXPECT_GE(c.max_recursion_depth, 1u);
+    EXPECT_GT(c.base_case_calls, 0u);
+    EXPECT_GT(c.find_pivots_calls, 0u);
+    EXPECT_GT(c.ds_pulls, 0u);
+    EXPECT_GE(c.ds_pull_buffer_pairs, c.max_pull_buffer);
+    EXPECT_GT(c.base_case_relaxations + c.bmssp_relaxations, 0u);
+}
+#endif
+
+TEST_F(Test_Utils, test_csr_graph_matches_boost_graph) {
+    Graph G = random_barabasi_albert(5, 3, 30, 10, 123);
+    CSR_Graph from_graph(G);
+    CSR_Graph from_edges(random_barabasi_albert_edges(5, 3, 30, 10, 123));
+
+    EXPECT_EQ(from_graph.num_vertices(), boost::num_vertices(G));
+    EXPECT_EQ(from_graph.num_edges(), boost::num_edges(G));
+    EXPECT_EQ(boost_to_map(from_edges.to_graph()), boost_to_map(G));
+
+    for (Node_id_T u = 0; u < from_graph.num_vertices(); u++) {
+        ASSERT_EQ(from_graph.out_degree(u), from_edges.out_degree(u));
+        auto e1 = from_graph.out_edges(u).begin();
+        auto e2 = from_edges.out_edges(u).begin();
+        for (; e1 != from_graph.out_edges(u).end(); ++e1, ++e2) {
+            EXPECT_EQ((*e1).to, (*e2).to); // same order as boost::add_edge
+            EXPECT_EQ((*e1).w, (*e2).w);
+        }
+    }
+}
+
+TEST_F(Test_Utils, test_csr_graph_weight_summary) {
+    CSR_Graph grid(grid_graph_edges(4, 5));
+    EXPECT_TRUE(grid.has_integer_weights());
+    EXPECT_EQ(grid.max_weight(), 1);
+
+    Edge_List edges;
+    edges.add_edge(0, 1, 3);
+    edges.add_edge(1, 2, 0.5);
+    CSR_Graph fractional(edges);
+    EXPECT_FALSE(fractional.has_integer_weights());
+    EXPECT_EQ(fractional.max_weight(), 3);
+}
+
+TEST_F(Test_Utils, test_csr_snapshot_round_trip) {
+    CSR_Graph g(random_barabasi_albert_edges(50, 3, 300, 10, 42));
+    string snapshot = ::testing::TempDir() + "test_utils_snapshot.csr";
+    FileUtils::write_csr_snapshot(snapshot, g);
+
+    CSR_Graph mapped = go_get_that_csr_graph(snapshot);
+    EXPECT_EQ(mapped.num_vertices(), g.num_vertices());
+    EXPECT_EQ(mapped.num_edges(), g.num_edges());
+    EXPECT_EQ(mapped.has_integer_weights(), g.has_integer_weights());
+    EXPECT_EQ(mapped.max_weight(), g.max_weight());
+    for (Node_id_T u = 0; u < g.num_vertices(); u++) {
+        ASSERT_EQ(mapped.edges_begin(u), g.edges_begin(u));
+        ASSERT_EQ(mapped.edges_end(u), g.edges_end(u));
+    }
+    for (CSR_Graph::Edge_id_T e = 0; e < g.num_edges(); e++) {
+        EXPECT_EQ(mapped.target(e), g.target(e));
+        EXPECT_EQ(mapped.weight(e), g.weight(e));
+    }
+
+    CSR_Graph copy = mapped; // shares the mapping
+    mapped = CSR_Graph();
+    EXPECT_EQ(copy.num_edges(), g.num_edges());
+    EXPECT_EQ(copy.target(g.num_edges()-1), g.target(g.num_edges()-1));
+    remove(snapshot.c_str());
+}
+
+TEST_F(Test_Utils, test_many_to_many_matches_dijkstra) {
+    Edge_List edges = random_barabasi_albert_edges(2000, 3, 8000, 10, 42);
+    edges.add_edge(8005, 8006, 1); // unreachable from the sources
+    CSR_Graph g(edges);
+    mt19937 rng(7);
+    uniform_int_distribution<Node_id_T> pick(0, 7999);
+    vector<Node_id_T> sources, targets;
+    for (int i = 0; i < 40; i++) {
+        sources.push_back(pick(rng));
+    }
+    for (int i = 0; i < 70; i++) { // more than two tiles of columns
+        targets.push_back(pick(rng));
+    }
+    targets.push_back(targets[3]); // a target twice
+    targets.push_back(sources[0]);
+    targets.push_back(8006);
+
+    for (const int &threads : {1, 3}) {
+        Distance_Matrix matrix = many_to_many(g, sources, targets, threads);
+        ASSERT_EQ(matrix.rows(), static_cast<int>(sources.size()));
+        ASSERT_EQ(matrix.cols(), static_cast<int>(targets.size()));
+        for (size_t i = 0; i < sources.size(); i++) {
+            Dist_List_T dist = min_heap_dijkstra(g, sources[i], g.num_vertices()).first;
+            for (size_t j = 0; j < targets.size(); j++) {
+                ASSERT_EQ(matrix.at(i, j), dist[targets[j]]) << "from " << sources[i] << " to " << targets[j];
+            }
+        }
+    }
+    EXPECT_EQ(many_to_many(g, sources, targets).col(1), many_to_many(g, sources, targets, 2).col(1));
+    EXPECT_THROW(many_to_many(g, {g.num_vertices()}, targets), invalid_argument);
+}
+
+TEST_F(Test_Utils, test_sssp_cache_lru) {
+    CSR_Graph g(random_barabasi_albert_edges(500, 3, 3000, 10, 42));
+    CSR_Graph other(random_barabasi_albert_edges(500, 3, 3000, 10, 43));
+    const size_t result_size = SSSP_Cache::size_of(top_level_BMSSP(g, 0, g.num_vertices()));
+    SSSP_Cache cache(2 * result_size);
+    Cached_SSSP cached(g, cache), cached_other(other, cache);
+    ASSERT_NE(cached.fingerprint(), cached_other.fingerprint());
+
+    EXPECT_EQ(*cached.query(0), top_level_BMSSP(g, 0, g.num_vertices()));
+    EXPECT_EQ(*cached.query(1), top_level_BMSSP(g, 1, g.num_vertices()));
+    auto first = cached.query(0); // a hit, 0 becomes the most recently used
+    EXPECT_EQ(*cached_other.query(0), top_level_BMSSP(other, 0, other.num_vertices())); // evicts 1
+    SSSP_Cache_Stats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.bytes, 2 * result_size);
+    EXPECT_EQ(cache.get(cached.fingerprint(), 0), first);
+    EXPECT_EQ(cache.get(cached.fingerprint(), 1), nullptr);
+
+    SSSP_Cache small(result_size - 1); // too small for any result
+    EXPECT_EQ(*Cached_SSSP(g, small).query(2), top_level_BMSSP(g, 2, g.num_vertices()));
+    EXPECT_EQ(small.stats().entries, 0u);
+
+    // concurrent readers of a few sources
+    SSSP_Cache shared(3 * result_size);
+    Cached_SSSP hubs(g, shared);
+    vector<Dist_List_T> expected;
+    for (Node_id_T s = 0; s < 4; s++) {
+        expected.push_back(top_level_BMSSP(g, s, g.num_vertices()).first);
+    }
+    atomic<int> wrong{0};
+    vector<thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&, t]() {
+            for (int i = 0; i < 50; i++) {
+                Node_id_T s = (t + i) % 4;
+                if (hubs.query(s)->first != expected[s]) {
+                    wrong++;
+                }
+            }
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(wrong, 0);
+    EXPECT_EQ(shared.stats().hits + shared.stats().misses, 200u);
+    EXPECT_LE(shared.stats().bytes, 3 * result_size);
+}
+
+TEST_F(Test_Utils, test_sssp_result_file_round_trip) {
+    CSR_Graph g(random_barabasi_albert_edges(1000, 3, 6000, 10, 42));
+    SSSP_Result result = top_level_BMSSP(g, 0, g.num_vertices());
+    result.first[g.num_vertices()-1] = INF; // an unreached vertex
+    result.second[g.num_vertices()-1] = -1;
+    result.second[1] = g.num_vertices()-2; // a far parent, several bytes of varint
+
+    SSSP_Result_Writer writer(SSSP_RESULT_DELTA_PARENTS);
+    vector<pair<string, uint32_t>> files;
+    for (uint32_t flags = 0; flags < 4; flags++) {
+        files.emplace_back(::testing::TempDir() + "test_utils_result_" + to_string(flags) + ".bin", flags);
+        write_sssp_result(files.back().first, 0, result, flags);
+    }
+    const string async_file = ::testing::TempDir() + "test_utils_result_async.bin";
+    writer.write(async_file, 0, result);
+    writer.wait();
+    files.emplace_back(async_file, SSSP_RESULT_DELTA_PARENTS);
+
+    for (const auto &file : files) {
+        SSSP_Result_File mapped(file.first);
+        EXPECT_EQ(mapped.num_vertices(), g.num_vertices());
+        EXPECT_EQ(mapped.source(), 0);
+        EXPECT_EQ(mapped.flags(), file.second);
+        const bool quantized = (file.second & SSSP_RESULT_FLOAT_DISTANCES) != 0;
+        const SSSP_Result read = mapped.result();
+        EXPECT_EQ(read.second, result.second);
+        for (Node_id_T v = 0; v < g.num_vertices(); v++) {
+            const Dist_T expected = quantized && result.first[v] < INF ? static_cast<float>(result.first[v]) : result.first[v];
+            ASSERT_EQ(mapped.distance(v), expected);
+            ASSERT_EQ(read.first[v], expected);
+            ASSERT_EQ(mapped.parent(v), result.second[v]);
+        }
+        remove(file.first.c_str());
+    }
+
+    writer.write(::testing::TempDir() + "missing_directory/result.bin", 0, result);
+    EXPECT_THROW(writer.wait(), runtime_error);
+}
+
+static void expect_same_csr(const CSR_Graph &a, const CSR_Graph &b) {
+    ASSERT_EQ(a.num_vertices(), b.num_vertices());
+    ASSERT_EQ(a.num_edges(), b.num_edges());
+    for (Node_id_T u = 0; u <= a.num_vertices(); u++) {
+        ASSERT_EQ(a.offsets_data()[u], b.offsets_data()[u]);
+    }
+    for (CSR_Graph::Edge_id_T e = 0; e < a.num_edges(); e++) {
+        EXPECT_EQ(a.target(e), b.target(e));
+        EXPECT_EQ(a.weight(e), b.weight(e));
+    }
+}
+
+TEST_F(Test_Utils, test_stream_graphml_matches_read_graphml) {
+    string path = ::testing::TempDir() + "test_utils_stream.graphml";
+    {
+        ofstream file(path);
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+             << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+             << "  <key id=\"d0\" for=\"node\" attr.name=\"name\" attr.type=\"string\"/>\n"
+             << "  <key id=\"d1\" for=\"edge\" attr.name=\"curv\" attr.type=\"double\"/>\n"
+             << "  <key id=\"d2\" for=\"edge\" attr.name=\"distance\" attr.type=\"double\"><default>2.5</default></key>\n"
+             << "  <graph id=\"G\" edgedefault=\"undirected\">\n";
+        for (int i = 0; i < 40; i++) {
+            if (i % 3 == 0) {
+                file << "    <node id=\"as" << i * 7 << "\"><data key=\"d0\">AS" << i << "</data></node>\n";
+            } else {
+                file << "    <node id=\"as" << i * 7 << "\"/>\n";
+            }
+        }
+        for (int i = 0; i < 120; i++) {
+            int u = (i * 13) % 40, v = (i * 29 + 5) % 40;
+            file << "    <edge id=\"e" << i << "\" source=\"as" << u * 7 << "\" target=\"as" << v * 7 << "\">";
+            if (i % 4 != 0) {
+                file << "<data key=\"d1\">0.5</data><data key=\"d2\">" << (i % 9) + 0.25 << "</data>";
+            }
+            file << "</edge>\n";
+        }
+        file << "  </graph>\n</graphml>\n";
+    }
+
+    CSR_Graph expected(FileUtils::read_bgp_graphml(path, false).first);
+    for (int threads : {1, 3}) {
+        for (size_t block_size : {size_t(64), size_t(1000), STREAM_BLOCK_SIZE}) {
+            auto streamed = FileUtils::stream_graphml(path, threads, "distance", 1.0, false, block_size);
+            expect_same_csr(streamed.first, expected);
+            EXPECT_EQ(streamed.second.edges_count, 120);
+        }
+    }
+    remove(path.c_str());
+}
+
+TEST_F(Test_Utils, test_stream_edge_list) {
+    string path = ::testing::TempDir() + "test_utils_stream.txt";
+    Edge_List edges;
+    {
+        ofstream file(path);
+        file << "# src dst weight\n";
+        for (int i = 0; i < 200; i++) {
+            int u = (i * 17) % 61, v = (i * 5 + 3) % 61;
+            if (i % 5 == 0) {
+                file << u << " " << v << "\n";
+                edges.add_edge(u, v, 1);
+            } else {
+                file << u << "\t" << v << " " << i * 0.5 << "\n";
+                edges.add_edge(u, v, i * 0.5);
+            }
+        }
+    }
+
+    for (int threads : {1, 4}) {
+        auto streamed = FileUtils::stream_edge_list(path, threads, false, false, 50);
+        expect_same_csr(streamed.first, CSR_Graph(edges));
+        EXPECT_EQ(streamed.second.edges_count, 200);
+        EXPECT_EQ(streamed.second.nodes_count, edges.nodes_count);
+
+        auto undirected = FileUtils::stream_edge_list(path, threads, true, false, 50);
+        EXPECT_EQ(undirected.first.num_edges(), 400);
+    }
+
+    for (const char *line : {"-1 3 1.5", "3 -2", "2147483648 1", "1 99999999999999999999 2"}) {
+        ofstream(path) << "0 1 1\n" << line << "\n";
+        EXPECT_THROW(FileUtils::stream_edge_list(path, 2, false, false, 50), runtime_error) << line;
+    }
+    remove(path.c_str());
+}